@@ -203,6 +203,8 @@ void Config::Load() {
 #endif
     Settings::values.shaders_accurate_gs = ReadSetting("shaders_accurate_gs", true).toBool();
     Settings::values.shaders_accurate_mul = ReadSetting("shaders_accurate_mul", false).toBool();
+    Settings::values.shader_jit_remove_dead_code =
+        ReadSetting("shader_jit_remove_dead_code", false).toBool();
     Settings::values.bg_red = ReadSetting("bg_red", 0.0).toFloat();
     Settings::values.bg_green = ReadSetting("bg_green", 0.0).toFloat();
     Settings::values.bg_blue = ReadSetting("bg_blue", 0.0).toFloat();
@@ -261,12 +263,18 @@ void Config::Load() {
     settings->endGroup();
     settings->beginGroup("Miscellaneous");
     Settings::values.log_filter = ReadSetting("log_filter", "*:Info").toString().toStdString();
+    Settings::values.profile_timing_events = ReadSetting("profile_timing_events", false).toBool();
+    Settings::values.profile_hle_calls = ReadSetting("profile_hle_calls", false).toBool();
     settings->endGroup();
     settings->beginGroup("Hacks");
     Settings::values.priority_boost = ReadSetting("priority_boost", false).toBool();
     Settings::values.ticks_mode =
         static_cast<Settings::TicksMode>(ReadSetting("ticks_mode", 0).toInt());
     Settings::values.ticks = ReadSetting("ticks", 0).toULongLong();
+    Settings::values.idle_loop_skipping_titles.clear();
+    for (const auto& program_id :
+         ReadSetting("idle_loop_skipping_titles", QStringList()).toStringList())
+        Settings::values.idle_loop_skipping_titles.insert(program_id.toULongLong(nullptr, 16));
     Settings::values.ignore_format_reinterpretation =
         ReadSetting("ignore_format_reinterpretation", false).toBool();
     Settings::values.force_memory_mode_7 = ReadSetting("force_memory_mode_7", false).toBool();
@@ -473,6 +481,8 @@ void Config::Save() {
     WriteSetting("use_hw_shaders", Settings::values.use_hw_shaders, true);
     WriteSetting("shaders_accurate_gs", Settings::values.shaders_accurate_gs, true);
     WriteSetting("shaders_accurate_mul", Settings::values.shaders_accurate_mul, false);
+    WriteSetting("shader_jit_remove_dead_code", Settings::values.shader_jit_remove_dead_code,
+                 false);
     // Cast to double because Qt's written float values aren't human-readable
     WriteSetting("bg_red", static_cast<double>(Settings::values.bg_red), 0.0);
     WriteSetting("bg_green", static_cast<double>(Settings::values.bg_green), 0.0);
@@ -528,11 +538,17 @@ void Config::Save() {
     settings->endGroup();
     settings->beginGroup("Miscellaneous");
     WriteSetting("log_filter", QString::fromStdString(Settings::values.log_filter), "*:Info");
+    WriteSetting("profile_timing_events", Settings::values.profile_timing_events, false);
+    WriteSetting("profile_hle_calls", Settings::values.profile_hle_calls, false);
     settings->endGroup();
     settings->beginGroup("Hacks");
     WriteSetting("priority_boost", Settings::values.priority_boost, false);
     WriteSetting("ticks_mode", static_cast<int>(Settings::values.ticks_mode), 0);
     WriteSetting("ticks", static_cast<unsigned long long>(Settings::values.ticks), 0);
+    QStringList idle_loop_skipping_titles;
+    for (u64 program_id : Settings::values.idle_loop_skipping_titles)
+        idle_loop_skipping_titles.append(QString::number(program_id, 16));
+    WriteSetting("idle_loop_skipping_titles", idle_loop_skipping_titles);
     WriteSetting("ignore_format_reinterpretation", Settings::values.ignore_format_reinterpretation);
     WriteSetting("force_memory_mode_7", Settings::values.force_memory_mode_7);
     WriteSetting("disable_mh_2xmsaa", Settings::values.disable_mh_2xmsaa);
@@ -35,6 +35,8 @@ void ConfigurationGeneral::LoadConfiguration(Core::System& system) {
     ui->combobox_keyboard_mode->setCurrentIndex(static_cast<int>(Settings::values.keyboard_mode));
     ui->show_logging_window->setChecked(UISettings::values.show_logging_window);
     ui->log_filter_edit->setText(QString::fromStdString(Settings::values.log_filter));
+    ui->profile_timing_events->setChecked(Settings::values.profile_timing_events);
+    ui->profile_hle_calls->setChecked(Settings::values.profile_hle_calls);
     ui->confirm_close->setChecked(UISettings::values.confirm_close);
 }
 
@@ -43,6 +45,8 @@ void ConfigurationGeneral::ApplyConfiguration() {
         static_cast<Settings::KeyboardMode>(ui->combobox_keyboard_mode->currentIndex());
     UISettings::values.show_logging_window = ui->show_logging_window->isChecked();
     Settings::values.log_filter = ui->log_filter_edit->text().toStdString();
+    Settings::values.profile_timing_events = ui->profile_timing_events->isChecked();
+    Settings::values.profile_hle_calls = ui->profile_hle_calls->isChecked();
     UISettings::values.confirm_close = ui->confirm_close->isChecked();
     Log::Filter filter;
     filter.ParseFilterString(Settings::values.log_filter);
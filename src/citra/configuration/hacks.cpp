@@ -23,6 +23,17 @@ void ConfigurationHacks::LoadConfiguration(Core::System& system) {
     ui->toggle_force_memory_mode_7->setChecked(Settings::values.force_memory_mode_7);
     ui->disable_mh_2xmsaa->setChecked(Settings::values.disable_mh_2xmsaa);
     bool powered_on{system.IsPoweredOn()};
+    if (powered_on) {
+        // Offer the value the adaptive mode settled on so it can be kept as custom ticks
+        if (Settings::values.ticks_mode == Settings::TicksMode::Adaptive &&
+            system.CPU().GetAdaptiveTicks() != 0)
+            ui->spinbox_ticks->setValue(static_cast<int>(system.CPU().GetAdaptiveTicks()));
+        u64 program_id{};
+        system.GetProgramLoader().ReadProgramID(program_id);
+        ui->toggle_skip_idle_loops->setChecked(
+            Settings::values.idle_loop_skipping_titles.count(program_id) != 0);
+    }
+    ui->toggle_skip_idle_loops->setEnabled(powered_on);
     ui->toggle_priority_boost->setEnabled(!powered_on);
     ui->toggle_force_memory_mode_7->setEnabled(!powered_on);
     ui->disable_mh_2xmsaa->setEnabled(!powered_on);
@@ -39,6 +50,13 @@ void ConfigurationHacks::ApplyConfiguration(Core::System& system) {
         ui->ignore_format_reinterpretation->isChecked();
     Settings::values.force_memory_mode_7 = ui->toggle_force_memory_mode_7->isChecked();
     Settings::values.disable_mh_2xmsaa = ui->disable_mh_2xmsaa->isChecked();
-    if (system.IsPoweredOn())
+    if (system.IsPoweredOn()) {
+        u64 program_id{};
+        system.GetProgramLoader().ReadProgramID(program_id);
+        if (ui->toggle_skip_idle_loops->isChecked())
+            Settings::values.idle_loop_skipping_titles.insert(program_id);
+        else
+            Settings::values.idle_loop_skipping_titles.erase(program_id);
         system.CPU().SyncSettings();
+    }
 }
@@ -51,6 +51,12 @@ static inline int LeastSignificantSetBit(u64 val) {
     _BitScanForward64(&index, val);
     return (int)index;
 }
+
+static inline int MostSignificantSetBit(u64 val) {
+    unsigned long index;
+    _BitScanReverse64(&index, val);
+    return (int)index;
+}
 #else
 static inline int CountSetBits(u8 val) {
     return __builtin_popcount(val);
@@ -83,6 +89,10 @@ static inline int LeastSignificantSetBit(u32 val) {
 static inline int LeastSignificantSetBit(u64 val) {
     return __builtin_ctzll(val);
 }
+
+static inline int MostSignificantSetBit(u64 val) {
+    return 63 - __builtin_clzll(val);
+}
 #endif
 
 // Similar to std::bitset, this is a class which encapsulates a bitset, i.e.
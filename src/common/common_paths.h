@@ -28,6 +28,7 @@
 
 // Filenames
 #define LOG_FILE "log.txt"
+#define HLE_CALLS_FILE "hle_calls.csv"
 
 // System files
 #define AES_KEYS "aes_keys.txt"
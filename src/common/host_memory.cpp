@@ -0,0 +1,57 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "common/host_memory.h"
+#include "common/logging/log.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <sys/mman.h>
+#endif
+
+namespace Common {
+
+HostMemory::HostMemory(std::size_t backing_size) : backing_size{backing_size} {
+    backing_base = AllocateAnonymous();
+    if (!backing_base) {
+        // Value initialization zeroes the buffer, which touches every page up front
+        fallback_backing = std::make_unique<u8[]>(backing_size);
+        backing_base = fallback_backing.get();
+    }
+}
+
+HostMemory::~HostMemory() {
+    if (fallback_backing)
+        return;
+#ifdef _WIN32
+    VirtualFree(backing_base, 0, MEM_RELEASE);
+#else
+    munmap(backing_base, backing_size);
+#endif
+}
+
+u8* HostMemory::AllocateAnonymous() {
+    // Anonymous mappings are zero-filled on demand, so pages the application never touches are
+    // never committed
+#ifdef _WIN32
+    void* base{VirtualAlloc(nullptr, backing_size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE)};
+    if (!base) {
+        LOG_ERROR(Common_Memory, "VirtualAlloc failed: {}", GetLastError());
+        return nullptr;
+    }
+#else
+    void* base{mmap(nullptr, backing_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                    -1, 0)};
+    if (base == MAP_FAILED) {
+        LOG_ERROR(Common_Memory, "Failed to allocate backing memory: {}", std::strerror(errno));
+        return nullptr;
+    }
+#endif
+    return static_cast<u8*>(base);
+}
+
+} // namespace Common
@@ -0,0 +1,36 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include "common/common_types.h"
+
+namespace Common {
+
+/**
+ * A block of zero-initialized host memory backing emulated physical memory. Pages are only
+ * committed by the host when they're first touched.
+ */
+class HostMemory final : NonCopyable {
+public:
+    explicit HostMemory(std::size_t backing_size);
+    ~HostMemory();
+
+    u8* BackingBasePointer() const {
+        return backing_base;
+    }
+
+private:
+    /// Allocates backing memory that the host zero-fills on demand
+    u8* AllocateAnonymous();
+
+    std::size_t backing_size;
+    u8* backing_base{};
+    /// Backing memory used when the host memory couldn't be mapped
+    std::unique_ptr<u8[]> fallback_backing;
+};
+
+} // namespace Common
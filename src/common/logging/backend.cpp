@@ -120,6 +120,7 @@ void DebuggerBackend::Write(const Entry& entry) {
     CLS(Log)                                                                                       \
     CLS(Common)                                                                                    \
     SUB(Common, Filesystem)                                                                        \
+    SUB(Common, Memory)                                                                            \
     CLS(Core)                                                                                      \
     SUB(Core, ARM11)                                                                               \
     SUB(Core, Timing)                                                                              \
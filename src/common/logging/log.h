@@ -34,6 +34,7 @@ enum class Class : u8 {
     Log,               ///< Messages about the log system itself
     Common,            ///< Library routines
     Common_Filesystem, ///< Filesystem interface library
+    Common_Memory,     ///< Host memory management
     Core,              ///< LLE emulation core
     Core_ARM11,        ///< ARM11 CPU core
     Core_Timing,       ///< CoreTiming functions
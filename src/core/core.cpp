@@ -7,6 +7,8 @@
 #include <enet/enet.h>
 #include "audio_core/hle/hle.h"
 #include "audio_core/lle/lle.h"
+#include "common/common_paths.h"
+#include "common/file_util.h"
 #include "common/logging/log.h"
 #include "core/cheats/cheats.h"
 #include "core/core.h"
@@ -174,6 +176,9 @@ System::ResultStatus System::Init(Frontend& frontend, u32 system_mode) {
     memory = std::make_unique<Memory::MemorySystem>(*this);
     LOG_DEBUG(HW_Memory, "initialized OK");
     timing = std::make_unique<Core::Timing>();
+    if (Settings::values.profile_timing_events)
+        timing->SetEventProfiler(&perf_stats);
+    perf_stats.SetHLECallProfiling(Settings::values.profile_hle_calls);
     kernel = std::make_unique<Kernel::KernelSystem>(*this);
     // Initialize FS, CFG and memory
     service_manager = std::make_unique<Service::SM::ServiceManager>(*this);
@@ -292,6 +297,9 @@ void System::Shutdown() {
     service_manager.reset();
     dsp_core.reset();
     timing.reset();
+    perf_stats.DumpTimingEventStats();
+    perf_stats.DumpHLECallStats(FileUtil::GetUserPath(FileUtil::UserPath::UserDir) +
+                                HLE_CALLS_FILE);
     program_loader.reset();
     memory.reset();
     room_member->SetProgram(std::string{});
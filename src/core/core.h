@@ -141,6 +141,11 @@ public:
         return *cpu_core;
     }
 
+    /// Indicates if the emulated CPU exists. It's destroyed before the kernel on shutdown.
+    bool IsCPUInitialized() const {
+        return cpu_core != nullptr;
+    }
+
     /// Gets a reference to the emulated DSP.
     AudioCore::DspInterface& DSP() {
         return *dsp_core;
@@ -10,6 +10,7 @@
 #include "common/logging/log.h"
 #include "common/thread.h"
 #include "core/core_timing.h"
+#include "core/perf_stats.h"
 
 namespace Core {
 
@@ -22,6 +23,14 @@ bool Timing::Event::operator<(const Event& right) const {
     return std::tie(time, fifo_order) < std::tie(right.time, right.fifo_order);
 }
 
+bool Timing::EventKey::operator==(const EventKey& right) const {
+    return type == right.type && userdata == right.userdata;
+}
+
+std::size_t Timing::EventKeyHash::operator()(const EventKey& key) const {
+    return std::hash<const TimingEventType*>{}(key.type) ^ (std::hash<u64>{}(key.userdata) << 1);
+}
+
 TimingEventType* Timing::RegisterEvent(const std::string& name, TimedCallback callback) {
     // Check for existing type with same name.
     // We want event type names to remain unique so that we can use them for serialization.
@@ -54,6 +63,10 @@ u64 Timing::GetIdleTicks() const {
     return static_cast<u64>(idled_cycles);
 }
 
+u64 Timing::GetDispatchedEventCount() const {
+    return dispatched_events;
+}
+
 void Timing::ScheduleEvent(s64 cycles_into_future, const TimingEventType* event_type,
                            u64 userdata) {
     ASSERT(event_type);
@@ -61,8 +74,7 @@ void Timing::ScheduleEvent(s64 cycles_into_future, const TimingEventType* event_
     // If this event needs to be scheduled before the next Advance(), force one early
     if (!is_global_timer_sane)
         ForceExceptionCheck(cycles_into_future);
-    event_queue.emplace_back(Event{timeout, event_fifo_id++, userdata, event_type});
-    std::push_heap(event_queue.begin(), event_queue.end(), std::greater<>());
+    PushEvent(Event{timeout, event_fifo_id++, userdata, event_type});
 }
 
 void Timing::ScheduleEventThreadsafe(s64 cycles_into_future, const TimingEventType* event_type,
@@ -71,24 +83,18 @@ void Timing::ScheduleEventThreadsafe(s64 cycles_into_future, const TimingEventTy
 }
 
 void Timing::UnscheduleEvent(const TimingEventType* event_type, u64 userdata) {
-    auto itr{std::remove_if(event_queue.begin(), event_queue.end(), [&](const Event& e) {
-        return e.type == event_type && e.userdata == userdata;
-    })};
-    // Removing random items breaks the invariant so we have to re-establish it.
-    if (itr != event_queue.end()) {
-        event_queue.erase(itr, event_queue.end());
-        std::make_heap(event_queue.begin(), event_queue.end(), std::greater<>());
-    }
+    const EventKey key{event_type, userdata};
+    for (auto itr{event_index.find(key)}; itr != event_index.end(); itr = event_index.find(key))
+        EraseEvent(itr->second);
 }
 
 void Timing::RemoveEvent(const TimingEventType* event_type) {
-    auto itr{std::remove_if(event_queue.begin(), event_queue.end(),
-                            [&](const Event& e) { return e.type == event_type; })};
-    // Removing random items breaks the invariant so we have to re-establish it.
-    if (itr != event_queue.end()) {
-        event_queue.erase(itr, event_queue.end());
-        std::make_heap(event_queue.begin(), event_queue.end(), std::greater<>());
-    }
+    std::vector<std::size_t> slots;
+    for (std::size_t slot : event_queue)
+        if (event_slots[slot].event.type == event_type)
+            slots.push_back(slot);
+    for (std::size_t slot : slots)
+        EraseEvent(slot);
 }
 
 void Timing::RemoveNormalAndThreadsafeEvent(const TimingEventType* event_type) {
@@ -107,9 +113,79 @@ void Timing::ForceExceptionCheck(s64 cycles) {
 void Timing::MoveEvents() {
     for (Event ev; ts_queue.Pop(ev);) {
         ev.fifo_order = event_fifo_id++;
-        event_queue.emplace_back(std::move(ev));
-        std::push_heap(event_queue.begin(), event_queue.end(), std::greater<>());
+        PushEvent(ev);
+    }
+}
+
+void Timing::PushEvent(const Event& event) {
+    std::size_t slot;
+    if (free_event_slots.empty()) {
+        slot = event_slots.size();
+        event_slots.push_back(QueuedEvent{event, event_queue.size()});
+    } else {
+        slot = free_event_slots.back();
+        free_event_slots.pop_back();
+        event_slots[slot] = QueuedEvent{event, event_queue.size()};
+    }
+    event_queue.push_back(slot);
+    event_index.emplace(EventKey{event.type, event.userdata}, slot);
+    SiftUp(event_queue.size() - 1);
+}
+
+void Timing::EraseEvent(std::size_t slot) {
+    const auto& event{event_slots[slot].event};
+    auto range{event_index.equal_range(EventKey{event.type, event.userdata})};
+    for (auto itr{range.first}; itr != range.second; ++itr)
+        if (itr->second == slot) {
+            event_index.erase(itr);
+            break;
+        }
+    std::size_t heap_index{event_slots[slot].heap_index};
+    std::size_t last{event_queue.size() - 1};
+    if (heap_index != last)
+        SwapHeapEntries(heap_index, last);
+    event_queue.pop_back();
+    // The entry moved into the hole can belong either above or below it
+    if (heap_index < event_queue.size()) {
+        SiftDown(heap_index);
+        SiftUp(heap_index);
     }
+    free_event_slots.push_back(slot);
+}
+
+void Timing::SwapHeapEntries(std::size_t a, std::size_t b) {
+    std::swap(event_queue[a], event_queue[b]);
+    event_slots[event_queue[a]].heap_index = a;
+    event_slots[event_queue[b]].heap_index = b;
+}
+
+void Timing::SiftUp(std::size_t heap_index) {
+    while (heap_index != 0) {
+        std::size_t parent{(heap_index - 1) / 2};
+        if (!(event_slots[event_queue[heap_index]].event <
+              event_slots[event_queue[parent]].event))
+            break;
+        SwapHeapEntries(heap_index, parent);
+        heap_index = parent;
+    }
+}
+
+void Timing::SiftDown(std::size_t heap_index) {
+    for (;;) {
+        std::size_t smallest{heap_index};
+        for (std::size_t child : {heap_index * 2 + 1, heap_index * 2 + 2})
+            if (child < event_queue.size() &&
+                event_slots[event_queue[child]].event < event_slots[event_queue[smallest]].event)
+                smallest = child;
+        if (smallest == heap_index)
+            break;
+        SwapHeapEntries(heap_index, smallest);
+        heap_index = smallest;
+    }
+}
+
+const Timing::Event& Timing::NextEvent() const {
+    return event_slots[event_queue.front()].event;
 }
 
 void Timing::Advance() {
@@ -118,17 +194,24 @@ void Timing::Advance() {
     global_timer += cycles_executed;
     slice_length = MAX_SLICE_LENGTH;
     is_global_timer_sane = true;
-    while (!event_queue.empty() && event_queue.front().time <= global_timer) {
-        Event evt{std::move(event_queue.front())};
-        std::pop_heap(event_queue.begin(), event_queue.end(), std::greater<>());
-        event_queue.pop_back();
-        evt.type->callback(evt.userdata, global_timer - evt.time);
+    while (!event_queue.empty() && NextEvent().time <= global_timer) {
+        Event evt{NextEvent()};
+        EraseEvent(event_queue.front());
+        ++dispatched_events;
+        s64 cycles_late{global_timer - evt.time};
+        if (event_profiler) {
+            auto start{PerfStats::Clock::now()};
+            evt.type->callback(evt.userdata, cycles_late);
+            event_profiler->AddTimingEventSample(*evt.type->name,
+                                                 PerfStats::Clock::now() - start, cycles_late);
+        } else
+            evt.type->callback(evt.userdata, cycles_late);
     }
     is_global_timer_sane = false;
     // Still events left (scheduled in the future)
     if (!event_queue.empty())
         slice_length = static_cast<int>(
-            std::min<s64>(event_queue.front().time - global_timer, MAX_SLICE_LENGTH));
+            std::min<s64>(NextEvent().time - global_timer, MAX_SLICE_LENGTH));
     downcount = slice_length;
 }
 
@@ -145,4 +228,8 @@ s64 Timing::GetDowncount() const {
     return downcount;
 }
 
+void Timing::SetEventProfiler(PerfStats* perf_stats) {
+    event_profiler = perf_stats;
+}
+
 } // namespace Core
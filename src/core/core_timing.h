@@ -125,6 +125,8 @@ inline u64 cyclesToMs(s64 cycles) {
 
 namespace Core {
 
+class PerfStats;
+
 using TimedCallback = std::function<void(u64 userdata, s64 cycles_late)>;
 
 struct TimingEventType {
@@ -144,6 +146,9 @@ public:
     u64 GetIdleTicks() const;
     void AddTicks(u64 ticks);
 
+    /// Returns how many event callbacks have been dispatched by Advance() so far
+    u64 GetDispatchedEventCount() const;
+
     /// Returns the event_type identifier. if name isn't unique, it will assert.
     TimingEventType* RegisterEvent(const std::string& name, TimedCallback callback);
 
@@ -187,6 +192,12 @@ public:
 
     s64 GetDowncount() const;
 
+    /**
+     * Makes Advance() report the host time and lateness of every dispatched callback to
+     * perf_stats. Passing nullptr disables the instrumentation.
+     */
+    void SetEventProfiler(PerfStats* perf_stats);
+
 private:
     struct Event {
         s64 time;
@@ -198,6 +209,30 @@ private:
         bool operator<(const Event& right) const;
     };
 
+    struct EventKey {
+        const TimingEventType* type;
+        u64 userdata;
+
+        bool operator==(const EventKey& right) const;
+    };
+
+    struct EventKeyHash {
+        std::size_t operator()(const EventKey& key) const;
+    };
+
+    /// An event stored in the queue along with its current position in the heap
+    struct QueuedEvent {
+        Event event;
+        std::size_t heap_index;
+    };
+
+    void PushEvent(const Event& event);
+    void EraseEvent(std::size_t slot);
+    void SwapHeapEntries(std::size_t a, std::size_t b);
+    void SiftUp(std::size_t heap_index);
+    void SiftDown(std::size_t heap_index);
+    const Event& NextEvent() const;
+
     static constexpr int MAX_SLICE_LENGTH{20000};
 
     s64 global_timer{};
@@ -208,17 +243,22 @@ private:
     // elements remain stable regardless of rehashes/resizing.
     std::unordered_map<std::string, TimingEventType> event_types;
 
-    // The queue is a min-heap using std::make_heap/push_heap/pop_heap.
-    // We don't use std::priority_queue because we need to be able to serialize, unserialize and
-    // erase arbitrary events (RemoveEvent()) regardless of the queue order. These aren't
-    // accomodated by the standard adaptor class.
-    std::vector<Event> event_queue;
+    // The queue is an indexed binary min-heap. Events live in event_slots, whose entries never
+    // move, and event_queue holds slot indices in heap order. Every slot records its position in
+    // the heap and event_index maps (type, userdata) to the slots using it, so arbitrary events
+    // can be erased in O(log n) (UnscheduleEvent()) without rebuilding the heap.
+    std::vector<QueuedEvent> event_slots;
+    std::vector<std::size_t> free_event_slots;
+    std::vector<std::size_t> event_queue;
+    std::unordered_multimap<EventKey, std::size_t, EventKeyHash> event_index;
     u64 event_fifo_id{};
 
     // The queue for storing the events from other threads threadsafe until they will be added
     // to the event_queue by the emu thread
     Common::MPSCQueue<Event, false> ts_queue;
     s64 idled_cycles{};
+    u64 dispatched_events{};
+    PerfStats* event_profiler{};
 
     // Are we in a function that has been called from Advance()
     // If events are sheduled from a function that gets called from Advance(),
@@ -2,10 +2,12 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <cstring>
 #include <dynarmic/A32/a32.h>
 #include <dynarmic/A32/context.h>
 #include "common/assert.h"
+#include "common/logging/log.h"
 #include "core/core.h"
 #include "core/core_timing.h"
 #include "core/cpu/cpu.h"
@@ -26,12 +28,23 @@ static std::unordered_map<u64, u64> custom_ticks_map{{
     {0x000400000011D700, 6000},
 }};
 
+// Host memory assumed to be reserved for the code cache of each JIT instance. This is dynarmic's
+// default, the pinned version doesn't allow setting or querying it.
+constexpr std::size_t JIT_CODE_CACHE_SIZE{128 * 1024 * 1024};
+// Code cache memory the JIT pool may hold before the least recently used JIT is evicted
+constexpr std::size_t JIT_POOL_BUDGET{4 * JIT_CODE_CACHE_SIZE};
+
+// Adaptive ticks never charge less than the most aggressive value in custom_ticks_map per slice
+constexpr u64 ADAPTIVE_TICKS_MIN{570};
+// Number of VBlanks the guest pacing is measured over before the charge is adjusted
+constexpr u32 ADAPTIVE_TICKS_WINDOW{30};
+// Number of windows to stay put after overclocking didn't increase the program frame rate
+constexpr u32 ADAPTIVE_TICKS_HOLD_WINDOWS{10};
+
 class UserCallbacks final : public Dynarmic::A32::UserCallbacks {
 public:
     explicit UserCallbacks(Cpu& parent, Core::System& system)
-        : parent{parent}, system{system}, svc_context{system} {
-        SyncSettings();
-    }
+        : parent{parent}, system{system}, svc_context{system} {}
 
     ~UserCallbacks() = default;
 
@@ -52,18 +65,22 @@ public:
     }
 
     void MemoryWrite8(VAddr vaddr, std::uint8_t value) override {
+        parent.idle_loop.side_effect = true;
         system.Memory().Write8(vaddr, value);
     }
 
     void MemoryWrite16(VAddr vaddr, std::uint16_t value) override {
+        parent.idle_loop.side_effect = true;
         system.Memory().Write16(vaddr, value);
     }
 
     void MemoryWrite32(VAddr vaddr, std::uint32_t value) override {
+        parent.idle_loop.side_effect = true;
         system.Memory().Write32(vaddr, value);
     }
 
     void MemoryWrite64(VAddr vaddr, std::uint64_t value) override {
+        parent.idle_loop.side_effect = true;
         system.Memory().Write64(vaddr, value);
     }
 
@@ -73,6 +90,11 @@ public:
     }
 
     void CallSVC(std::uint32_t swi) override {
+        // GetSystemTick is the only SVC a polling loop may call without leaving the idle state
+        if (swi == 0x28)
+            parent.idle_loop.polled_tick = true;
+        else
+            parent.idle_loop.side_effect = true;
         svc_context.CallSVC(swi);
     }
 
@@ -82,6 +104,10 @@ public:
     }
 
     void AddTicks(std::uint64_t ticks) override {
+        if (adaptive_ticks) {
+            adaptive.executed_ticks += ticks;
+            ++adaptive.runs;
+        }
         system.CoreTiming().AddTicks(use_custom_ticks ? custom_ticks : ticks);
     }
 
@@ -93,6 +119,7 @@ public:
     void SyncSettings() {
         custom_ticks = Settings::values.ticks;
         use_custom_ticks = Settings::values.ticks_mode != Settings::TicksMode::Accurate;
+        adaptive_ticks = false;
         switch (Settings::values.ticks_mode) {
         case Settings::TicksMode::Custom: {
             custom_ticks = Settings::values.ticks;
@@ -117,13 +144,105 @@ public:
             use_custom_ticks = false;
             break;
         }
+        case Settings::TicksMode::Adaptive: {
+            // Start accurate and let OnVBlank() tune the charge
+            custom_ticks = 0;
+            use_custom_ticks = false;
+            adaptive_ticks = true;
+            adaptive = {};
+            StartAdaptiveWindow();
+            break;
+        }
         }
     }
 
+    /**
+     * Measures how much of the last ADAPTIVE_TICKS_WINDOW frames the guest spent idle. A guest
+     * that never idles can't fit its work into a frame, so the cycles charged per slice are
+     * lowered, as long as that keeps raising the program frame rate. A guest with plenty of idle
+     * time gets charged more again, up to accurate ticks.
+     */
+    void OnVBlank() {
+        if (!adaptive_ticks || ++adaptive.vblanks < ADAPTIVE_TICKS_WINDOW)
+            return;
+        auto& timing{system.CoreTiming()};
+        u64 window_ticks{timing.GetTicks() - adaptive.window_ticks};
+        u64 idle_ticks{timing.GetIdleTicks() - adaptive.window_idle_ticks};
+        u64 app_frames{system.perf_stats.GetTotalAppFrames() - adaptive.window_app_frames};
+        double idle_ratio{window_ticks == 0 ? 1.0
+                                            : static_cast<double>(idle_ticks) /
+                                                  static_cast<double>(window_ticks)};
+        // What a slice costs in accurate mode, the upper bound of the charge
+        u64 accurate_ticks{adaptive.runs == 0 ? 0 : adaptive.executed_ticks / adaptive.runs};
+        if (adaptive.hold_windows != 0)
+            --adaptive.hold_windows;
+        if (idle_ratio > 0.25) {
+            RaiseAdaptiveTicks(accurate_ticks);
+        } else if (idle_ratio < 0.02) {
+            if (adaptive.lowered && app_frames <= adaptive.app_frames_before_lowering) {
+                RaiseAdaptiveTicks(accurate_ticks);
+                adaptive.hold_windows = ADAPTIVE_TICKS_HOLD_WINDOWS;
+            } else if (adaptive.hold_windows == 0) {
+                u64 current{use_custom_ticks ? custom_ticks : accurate_ticks};
+                u64 lowered{std::max(current * 3 / 4, ADAPTIVE_TICKS_MIN)};
+                // Slices that already cost less than the floor can't be charged any less
+                if (lowered < accurate_ticks && lowered < current) {
+                    custom_ticks = lowered;
+                    use_custom_ticks = true;
+                    adaptive.lowered = true;
+                    adaptive.app_frames_before_lowering = app_frames;
+                    LOG_DEBUG(Core_ARM11, "Adaptive ticks lowered to {}", custom_ticks);
+                }
+            }
+        } else
+            adaptive.lowered = false;
+        StartAdaptiveWindow();
+    }
+
+    u64 GetAdaptiveTicks() const {
+        return use_custom_ticks ? custom_ticks : 0;
+    }
+
 private:
+    void StartAdaptiveWindow() {
+        auto& timing{system.CoreTiming()};
+        adaptive.window_ticks = timing.GetTicks();
+        adaptive.window_idle_ticks = timing.GetIdleTicks();
+        adaptive.window_app_frames = system.perf_stats.GetTotalAppFrames();
+        adaptive.vblanks = 0;
+        adaptive.executed_ticks = 0;
+        adaptive.runs = 0;
+    }
+
+    void RaiseAdaptiveTicks(u64 accurate_ticks) {
+        adaptive.lowered = false;
+        if (!use_custom_ticks)
+            return;
+        custom_ticks = custom_ticks * 4 / 3;
+        if (custom_ticks >= accurate_ticks) {
+            custom_ticks = 0;
+            use_custom_ticks = false;
+        }
+        LOG_DEBUG(Core_ARM11, "Adaptive ticks raised to {}", GetAdaptiveTicks());
+    }
+
+    struct AdaptiveTicksState {
+        u64 window_ticks;
+        u64 window_idle_ticks;
+        u64 window_app_frames;
+        u32 vblanks;
+        u64 executed_ticks;
+        u64 runs;
+        bool lowered;
+        u64 app_frames_before_lowering;
+        u32 hold_windows;
+    };
+
     Cpu& parent;
     u64 custom_ticks{};
     bool use_custom_ticks{};
+    bool adaptive_ticks{};
+    AdaptiveTicksState adaptive{};
     Core::System& system;
     Kernel::SVCContext svc_context;
 };
@@ -194,13 +313,35 @@ void ThreadContext::SetFpexc(u32 value) {
 Cpu::Cpu(Core::System& system)
     : cb{std::make_unique<UserCallbacks>(*this, system)}, system{system} {
     PageTableChanged();
+    SyncSettings();
 }
 
-Cpu::~Cpu() = default;
+Cpu::~Cpu() {
+    if (Settings::values.ticks_mode == Settings::TicksMode::Adaptive) {
+        u64 program_id{};
+        system.GetProgramLoader().ReadProgramID(program_id);
+        LOG_INFO(Core_ARM11, "Adaptive ticks for {:016X} settled at {}", program_id,
+                 cb->GetAdaptiveTicks());
+    }
+    if (idle_loop.skipped_cycles != 0)
+        LOG_INFO(Core_ARM11, "Idle loop skipping fast-forwarded {} cycles",
+                 idle_loop.skipped_cycles);
+}
 
 void Cpu::Run() {
     ASSERT(system.Memory().GetCurrentPageTable() == current_page_table);
+    auto& timing{system.CoreTiming()};
+    // Nothing the polling loop could observe has changed since it was last run, so jump straight
+    // to the next scheduled event
+    if (skip_idle_loops && idle_loop.matches >= IDLE_LOOP_THRESHOLD &&
+        idle_loop.event_count == timing.GetDispatchedEventCount()) {
+        idle_loop.skipped_cycles += static_cast<u64>(std::max<s64>(timing.GetDowncount(), 0));
+        timing.Idle();
+        return;
+    }
     jit->Run();
+    if (skip_idle_loops)
+        UpdateIdleLoopDetection();
 }
 
 void Cpu::SetPC(u32 pc) {
@@ -273,6 +414,7 @@ void Cpu::LoadContext(const std::unique_ptr<ThreadContext>& arg) {
     ASSERT(ctx);
     jit->LoadContext(*ctx->ctx);
     state.vfp[VFP_FPEXC] = ctx->fpexc;
+    ResetIdleLoopDetection();
 }
 
 void Cpu::PrepareReschedule() {
@@ -285,19 +427,92 @@ void Cpu::InvalidateCacheRange(u32 start_address, std::size_t length) {
 }
 
 void Cpu::PageTableChanged() {
+    ResetIdleLoopDetection();
     current_page_table = system.Memory().GetCurrentPageTable();
     auto iter{jits.find(current_page_table)};
-    if (iter != jits.end()) {
-        jit = iter->second.get();
+    if (iter == jits.end()) {
+        EvictJits();
+        iter = jits.emplace(current_page_table, JitEntry{MakeJit(), 0}).first;
+        LOG_DEBUG(Core_ARM11,
+                  "Created JIT for page table {}, {} JITs reserve about {} MiB of code cache",
+                  static_cast<void*>(current_page_table), jits.size(),
+                  EstimateJitCodeCacheBytes() >> 20);
+    }
+    iter->second.last_used = ++jit_use_counter;
+    jit = iter->second.jit.get();
+}
+
+void Cpu::PageTableRemoved(Memory::PageTable* page_table) {
+    auto iter{jits.find(page_table)};
+    if (iter == jits.end())
+        return;
+    // A process can be destroyed while its page table is still current. Its JIT is kept until the
+    // next switch, but must not run stale code if a new page table is created at the same address.
+    if (iter->second.jit.get() == jit) {
+        jit->ClearCache();
         return;
     }
-    auto new_jit{MakeJit()};
-    jit = new_jit.get();
-    jits.emplace(current_page_table, std::move(new_jit));
+    jits.erase(iter);
+}
+
+std::size_t Cpu::EstimateJitCodeCacheBytes() const {
+    return jits.size() * JIT_CODE_CACHE_SIZE;
+}
+
+void Cpu::EvictJits() {
+    while (!jits.empty() && (jits.size() + 1) * JIT_CODE_CACHE_SIZE > JIT_POOL_BUDGET) {
+        auto lru{std::min_element(jits.begin(), jits.end(), [](const auto& a, const auto& b) {
+            return a.second.last_used < b.second.last_used;
+        })};
+        // Never pull the JIT out from under code that is running on it
+        if (lru->second.jit->IsExecuting())
+            break;
+        LOG_DEBUG(Core_ARM11, "Evicting JIT for page table {}", static_cast<void*>(lru->first));
+        if (lru->second.jit.get() == jit)
+            jit = nullptr;
+        jits.erase(lru);
+    }
 }
 
 void Cpu::SyncSettings() {
     cb->SyncSettings();
+    u64 program_id{};
+    system.GetProgramLoader().ReadProgramID(program_id);
+    skip_idle_loops = Settings::values.idle_loop_skipping_titles.count(program_id) != 0;
+    ResetIdleLoopDetection();
+}
+
+void Cpu::OnVBlank() {
+    cb->OnVBlank();
+}
+
+u64 Cpu::GetAdaptiveTicks() const {
+    return cb->GetAdaptiveTicks();
+}
+
+u64 Cpu::GetIdleLoopSkippedCycles() const {
+    return idle_loop.skipped_cycles;
+}
+
+void Cpu::ResetIdleLoopDetection() {
+    idle_loop.matches = 0;
+    idle_loop.side_effect = true;
+    idle_loop.polled_tick = false;
+}
+
+void Cpu::UpdateIdleLoopDetection() {
+    const auto& regs{jit->Regs()};
+    // GetSystemTick returns its result in r0 and r1, which are expected to change every slice
+    const std::size_t first_reg{idle_loop.polled_tick ? 2u : 0u};
+    bool unchanged{!idle_loop.side_effect && jit->Cpsr() == idle_loop.cpsr &&
+                   std::equal(regs.begin() + first_reg, regs.end(),
+                              idle_loop.regs.begin() + first_reg)};
+    idle_loop.matches = unchanged ? idle_loop.matches + 1 : 0;
+    idle_loop.regs = regs;
+    idle_loop.cpsr = jit->Cpsr();
+    idle_loop.event_count = system.CoreTiming().GetDispatchedEventCount();
+    idle_loop.side_effect = false;
+    idle_loop.polled_tick = false;
 }
 
 std::unique_ptr<Dynarmic::A32::Jit> Cpu::MakeJit() {
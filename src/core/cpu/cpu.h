@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <array>
 #include <map>
 #include <memory>
 #include "common/common_types.h"
@@ -80,16 +81,65 @@ public:
     void InvalidateCacheRange(u32 start_address, std::size_t length);
     void PageTableChanged();
 
+    /// Drops the JIT compiled for a page table that is about to be destroyed
+    void PageTableRemoved(Memory::PageTable* page_table);
+
+    /// Estimates the host memory reserved for the code caches of the pooled JITs
+    std::size_t EstimateJitCodeCacheBytes() const;
+
     void SyncSettings();
 
+    /// Lets the adaptive ticks mode measure the guest frame pacing
+    void OnVBlank();
+
+    /// Returns the cycles charged per slice chosen by the adaptive ticks mode, 0 when accurate
+    u64 GetAdaptiveTicks() const;
+
+    /// Returns the number of guest cycles fast-forwarded by idle loop skipping
+    u64 GetIdleLoopSkippedCycles() const;
+
 private:
+    /**
+     * Tracks the guest state at slice boundaries to recognise side-effect-free polling loops.
+     * A thread whose registers are unchanged over several slices, without any SVC other than
+     * GetSystemTick, without callback memory writes and without any event being dispatched in
+     * between is only waiting for the next scheduled event, so its slices can be skipped.
+     */
+    struct IdleLoopState {
+        std::array<u32, 16> regs{};
+        u32 cpsr{};
+        u64 event_count{};
+        int matches{};
+        bool side_effect{true};
+        bool polled_tick{};
+        u64 skipped_cycles{};
+    };
+
+    /// Number of consecutive identical slices required before slices are skipped
+    static constexpr int IDLE_LOOP_THRESHOLD{2};
+
+    void ResetIdleLoopDetection();
+    void UpdateIdleLoopDetection();
+
+    /// A JIT in the pool along with when it was last switched to
+    struct JitEntry {
+        std::unique_ptr<Dynarmic::A32::Jit> jit;
+        u64 last_used;
+    };
+
     friend class UserCallbacks;
     std::unique_ptr<UserCallbacks> cb;
     std::unique_ptr<Dynarmic::A32::Jit> MakeJit();
 
+    /// Evicts the least recently used JITs until another one fits into the code cache budget
+    void EvictJits();
+
     Dynarmic::A32::Jit* jit;
     Memory::PageTable* current_page_table;
-    std::map<Memory::PageTable*, std::unique_ptr<Dynarmic::A32::Jit>> jits;
+    std::map<Memory::PageTable*, JitEntry> jits;
+    u64 jit_use_counter{};
     State state;
+    IdleLoopState idle_loop;
+    bool skip_idle_loops{};
     Core::System& system;
 };
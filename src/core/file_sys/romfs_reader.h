@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <mutex>
 #include "common/common_types.h"
 #include "common/file_util.h"
 
@@ -26,6 +27,9 @@ public:
 private:
     bool is_encrypted{};
     FileUtil::IOFile file;
+    /// Guards the position of the file, which is shared by all the files opened in the RomFS and
+    /// read from the file service worker threads
+    std::mutex file_mutex;
     std::array<u8, 16> key{};
     std::array<u8, 16> ctr{};
     std::size_t file_offset{};
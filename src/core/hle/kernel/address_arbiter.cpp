@@ -17,43 +17,39 @@ namespace Kernel {
 void AddressArbiter::WaitThread(SharedPtr<Thread> thread, VAddr wait_address) {
     thread->wait_address = wait_address;
     thread->status = ThreadStatus::WaitArb;
-    waiting_threads.emplace_back(std::move(thread));
+    waiting_threads[wait_address].emplace_back(std::move(thread));
 }
 
 void AddressArbiter::ResumeAllThreads(VAddr address) {
-    // Determine which threads are waiting on this address, those should be woken up.
-    auto itr{std::stable_partition(waiting_threads.begin(), waiting_threads.end(),
-                                   [address](const auto& thread) {
-                                       ASSERT_MSG(thread->status == ThreadStatus::WaitArb,
-                                                  "Inconsistent AddressArbiter state");
-                                       return thread->wait_address != address;
-                                   })};
-    // Wake up all the found threads
-    std::for_each(itr, waiting_threads.end(), [](auto& thread) { thread->ResumeFromWait(); });
-    // Remove the woken up threads from the wait list.
-    waiting_threads.erase(itr, waiting_threads.end());
+    // Wake up all the threads waiting on this address and remove them from the wait list.
+    auto itr{waiting_threads.find(address)};
+    if (itr == waiting_threads.end())
+        return;
+    auto threads{std::move(itr->second)};
+    waiting_threads.erase(itr);
+    for (auto& thread : threads) {
+        ASSERT_MSG(thread->status == ThreadStatus::WaitArb, "Inconsistent AddressArbiter state");
+        thread->ResumeFromWait();
+    }
 }
 
 SharedPtr<Thread> AddressArbiter::ResumeHighestPriorityThread(VAddr address) {
-    // Determine which threads are waiting on this address, those should be considered for wakeup.
-    auto matches_start{std::stable_partition(waiting_threads.begin(), waiting_threads.end(),
-                                             [address](const auto& thread) {
-                                                 ASSERT_MSG(thread->status == ThreadStatus::WaitArb,
-                                                            "Inconsistent AddressArbiter state");
-                                                 return thread->wait_address != address;
-                                             })};
+    auto list{waiting_threads.find(address)};
+    if (list == waiting_threads.end())
+        return nullptr;
+    auto& threads{list->second};
     // Iterate through threads, find highest priority thread that is waiting to be arbitrated.
     // Note: The real kernel will pick the first thread in the list if more than one have the
     // same highest priority value. Lower priority values mean higher priority.
-    auto itr{std::min_element(matches_start, waiting_threads.end(),
-                              [](const auto& lhs, const auto& rhs) {
-                                  return lhs->current_priority < rhs->current_priority;
-                              })};
-    if (itr == waiting_threads.end())
-        return nullptr;
+    auto itr{std::min_element(threads.begin(), threads.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs->current_priority < rhs->current_priority;
+    })};
     auto thread{*itr};
+    ASSERT_MSG(thread->status == ThreadStatus::WaitArb, "Inconsistent AddressArbiter state");
     thread->ResumeFromWait();
-    waiting_threads.erase(itr);
+    threads.erase(itr);
+    if (threads.empty())
+        waiting_threads.erase(list);
     return thread;
 }
 
@@ -73,8 +69,13 @@ ResultCode AddressArbiter::ArbitrateAddress(SharedPtr<Thread> thread, Arbitratio
                                  SharedPtr<WaitObject> object) {
         ASSERT(reason == ThreadWakeupReason::Timeout);
         // Remove the newly-awakened thread from the Arbiter's waiting list.
-        waiting_threads.erase(std::remove(waiting_threads.begin(), waiting_threads.end(), thread),
-                              waiting_threads.end());
+        auto list{waiting_threads.find(thread->wait_address)};
+        if (list == waiting_threads.end())
+            return;
+        auto& threads{list->second};
+        threads.erase(std::remove(threads.begin(), threads.end(), thread), threads.end());
+        if (threads.empty())
+            waiting_threads.erase(list);
     }};
     switch (type) {
     // Signal thread(s) waiting for arbitrate address...
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <unordered_map>
 #include <vector>
 #include "common/common_types.h"
 #include "core/hle/kernel/object.h"
@@ -60,8 +61,9 @@ private:
     /// the resumed thread.
     SharedPtr<Thread> ResumeHighestPriorityThread(VAddr address);
 
-    /// Threads waiting for the address arbiter to be signaled.
-    std::vector<SharedPtr<Thread>> waiting_threads;
+    /// Threads waiting for the address arbiter to be signaled, by arbitration address and in the
+    /// order they started waiting.
+    std::unordered_map<VAddr, std::vector<SharedPtr<Thread>>> waiting_threads;
 
     friend class KernelSystem;
 };
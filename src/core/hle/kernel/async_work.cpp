@@ -0,0 +1,84 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include "common/assert.h"
+#include "core/core_timing.h"
+#include "core/hle/kernel/async_work.h"
+#include "core/hle/kernel/event.h"
+
+namespace Kernel {
+
+AsyncWorkManager::AsyncWorkManager(Core::Timing& timing) : timing{timing} {
+    work_done_event_type = timing.RegisterEvent(
+        "AsyncWorkManager Callback Event",
+        [this](u64 work_id, s64 cycles_late) { WorkDoneCallback(work_id, cycles_late); });
+    const std::size_t num_workers{
+        std::clamp<std::size_t>(std::thread::hardware_concurrency() / 2, 1, 4)};
+    for (std::size_t i{}; i < num_workers; ++i)
+        workers.emplace_back([this] { WorkerLoop(); });
+}
+
+AsyncWorkManager::~AsyncWorkManager() {
+    {
+        std::lock_guard lock{queue_mutex};
+        stop_workers = true;
+    }
+    queue_cv.notify_all();
+    for (auto& worker : workers)
+        worker.join();
+}
+
+void AsyncWorkManager::Run(std::function<void()> work, SharedPtr<Event> event, s64 delay_ns) {
+    const u64 work_id{next_work_id++};
+    auto& pending{pending_work[work_id]};
+    pending.work = std::move(work);
+    pending.event = std::move(event);
+    {
+        std::lock_guard lock{queue_mutex};
+        queue.emplace_back(work_id, &pending.work);
+    }
+    queue_cv.notify_one();
+    timing.ScheduleEvent(nsToCycles(delay_ns), work_done_event_type, work_id);
+}
+
+void AsyncWorkManager::WorkerLoop() {
+    for (;;) {
+        std::unique_lock lock{queue_mutex};
+        queue_cv.wait(lock, [this] { return stop_workers || !queue.empty(); });
+        if (stop_workers)
+            return;
+        const auto [work_id, work]{queue.front()};
+        queue.pop_front();
+        lock.unlock();
+        (*work)();
+        lock.lock();
+        finished_work.insert(work_id);
+        lock.unlock();
+        finished_cv.notify_all();
+    }
+}
+
+void AsyncWorkManager::WorkDoneCallback(u64 work_id, s64 cycles_late) {
+    auto itr{pending_work.find(work_id)};
+    ASSERT(itr != pending_work.end());
+    std::unique_lock lock{queue_mutex};
+    const auto queued{std::find_if(queue.begin(), queue.end(),
+                                   [work_id](const auto& entry) { return entry.first == work_id; })};
+    if (queued != queue.end()) {
+        // No worker picked the work up in time, so run it here instead of waiting for one
+        queue.erase(queued);
+        lock.unlock();
+        itr->second.work();
+    } else {
+        // Wait for the work rather than signaling later, which would depend on the host speed
+        finished_cv.wait(lock, [this, work_id] { return finished_work.count(work_id) != 0; });
+        finished_work.erase(work_id);
+        lock.unlock();
+    }
+    itr->second.event->Signal();
+    pending_work.erase(itr);
+}
+
+} // namespace Kernel
@@ -0,0 +1,77 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "common/common_types.h"
+#include "core/hle/kernel/object.h"
+
+namespace Core {
+class Timing;
+struct TimingEventType;
+} // namespace Core
+
+namespace Kernel {
+
+class Event;
+
+/**
+ * Runs the expensive part of HLE service requests (host file IO, conversions, network requests)
+ * on host worker threads. The guest thread that made the request sleeps on an event, so other
+ * guest threads and the GPU keep running meanwhile. The event is signaled by a timing event at a
+ * fixed emulated time, which waits for the work if it isn't done yet, so the guest sees the same
+ * timing however fast the host is.
+ */
+class AsyncWorkManager {
+public:
+    explicit AsyncWorkManager(Core::Timing& timing);
+    ~AsyncWorkManager();
+
+    /**
+     * Queues work to run on a worker thread.
+     * @param work The work to run. It must not access guest memory or kernel objects.
+     * @param event Event to signal on the emulation thread once the work is done.
+     * @param delay_ns Emulated time after which the event is signaled.
+     */
+    void Run(std::function<void()> work, SharedPtr<Event> event, s64 delay_ns);
+
+private:
+    struct PendingWork {
+        /// Destroyed on the emulation thread, as it may hold the last reference to a service
+        std::function<void()> work;
+        SharedPtr<Event> event;
+    };
+
+    void WorkerLoop();
+
+    /// The timing callback, called on the emulation thread when a piece of work is due
+    void WorkDoneCallback(u64 work_id, s64 cycles_late);
+
+    Core::Timing& timing;
+    Core::TimingEventType* work_done_event_type;
+
+    // Only modified on the emulation thread. Workers access the work of queued entries, which stay
+    // in place until the emulation thread is done with them.
+    u64 next_work_id{};
+    std::unordered_map<u64, PendingWork> pending_work;
+
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;
+    std::deque<std::pair<u64, std::function<void()>*>> queue;
+    std::condition_variable finished_cv;
+    std::unordered_set<u64> finished_work; ///< Work done by the workers that isn't due yet
+    bool stop_workers{};
+    std::vector<std::thread> workers;
+};
+
+} // namespace Kernel
@@ -18,9 +18,21 @@ HandleTable::HandleTable(KernelSystem& kernel) : kernel{kernel} {
 
 HandleTable::~HandleTable() = default;
 
-Handle HandleTable::Create(SharedPtr<Object> obj) {
+ResultVal<Handle> HandleTable::Create(SharedPtr<Object> obj) {
     DEBUG_ASSERT(obj);
-    return objects.emplace(++handle_counter, std::move(obj)).first->first;
+    u16 slot{next_free_slot};
+    if (slot >= MAX_COUNT) {
+        LOG_ERROR(Kernel, "Unable to allocate handle, too many handles are open");
+        return ERR_OUT_OF_HANDLES;
+    }
+    next_free_slot = generations[slot];
+    u16 generation{next_generation++};
+    // Overflow count so it fits in the generation bits
+    if (next_generation >= (1 << GENERATION_BITS))
+        next_generation = 1;
+    generations[slot] = generation;
+    objects[slot] = std::move(obj);
+    return MakeResult<Handle>(slot | (static_cast<u32>(generation) << SLOT_BITS));
 }
 
 ResultVal<Handle> HandleTable::Duplicate(Handle handle) {
@@ -29,27 +41,41 @@ ResultVal<Handle> HandleTable::Duplicate(Handle handle) {
         LOG_ERROR(Kernel, "Tried to duplicate invalid handle {:08X}", handle);
         return ERR_INVALID_HANDLE;
     }
-    return MakeResult<Handle>(Create(std::move(object)));
+    return Create(std::move(object));
 }
 
 ResultCode HandleTable::Close(Handle handle) {
-    if (objects.find(handle) == objects.end())
+    if (!Find(handle))
         return ERR_INVALID_HANDLE;
-    objects.erase(handle);
+    u32 slot{GetSlot(handle)};
+    objects[slot] = nullptr;
+    generations[slot] = next_free_slot;
+    next_free_slot = static_cast<u16>(slot);
     return RESULT_SUCCESS;
 }
 
+const SharedPtr<Object>* HandleTable::Find(Handle handle) const {
+    u32 slot{GetSlot(handle)};
+    if (slot >= MAX_COUNT || !objects[slot] || generations[slot] != GetGeneration(handle))
+        return nullptr;
+    return &objects[slot];
+}
+
 SharedPtr<Object> HandleTable::GetGeneric(Handle handle) const {
     if (handle == CurrentThread)
         return kernel.GetThreadManager().GetCurrentThread();
     else if (handle == CurrentProcess)
         return kernel.GetCurrentProcess();
-    auto itr{objects.find(handle)};
-    return itr == objects.end() ? nullptr : itr->second;
+    auto object{Find(handle)};
+    return object ? *object : nullptr;
 }
 
 void HandleTable::Clear() {
-    objects.clear();
+    for (u16 i{}; i < MAX_COUNT; ++i) {
+        generations[i] = i + 1;
+        objects[i] = nullptr;
+    }
+    next_free_slot = 0;
 }
 
 } // namespace Kernel
@@ -4,9 +4,8 @@
 
 #pragma once
 
-#include <atomic>
+#include <array>
 #include <cstddef>
-#include <map>
 #include "common/common_types.h"
 #include "core/hle/kernel/object.h"
 #include "core/hle/result.h"
@@ -22,22 +21,31 @@ enum KernelHandle : Handle {
  * This class allows the creation of Handles, which are references to objects that can be tested
  * for validity and looked up. Here they are used to pass references to kernel objects to/from the
  * emulated process.
+ *
+ * Like in the real kernel, a handle is made of the index of the slot holding the object in its
+ * lower bits and a generation counter in its upper bits, so lookups are a single array access and
+ * stale handles to a reused slot are rejected.
  */
 class HandleTable final : NonCopyable {
 public:
+    /// Maximum number of handles that can be open at once in a table
+    static constexpr std::size_t MAX_COUNT{4096};
+
     explicit HandleTable(KernelSystem& kernel);
     ~HandleTable();
 
     /**
      * Allocates a handle for the given object.
-     * @return The created Handle
+     * @return The created Handle or one of the following errors:
+     * - `ERR_OUT_OF_HANDLES`: the table is full.
      */
-    Handle Create(SharedPtr<Object> obj);
+    ResultVal<Handle> Create(SharedPtr<Object> obj);
 
     /**
      * Returns a new handle that points to the same object as the passed in handle.
      * @return The duplicated Handle or one of the following errors:
      * - `ERR_INVALID_HANDLE`: an invalid handle was passed in.
+     * - `ERR_OUT_OF_HANDLES`: the table is full.
      */
     ResultVal<Handle> Duplicate(Handle handle);
 
@@ -68,8 +76,37 @@ public:
     void Clear();
 
 private:
-    std::map<Handle, SharedPtr<Object>> objects{};
-    std::atomic<u32> handle_counter{};
+    /// Number of lower bits of a handle used for the slot index
+    static constexpr u32 SLOT_BITS{15};
+
+    /// Number of bits of the generation counter, stored above the slot index
+    static constexpr u32 GENERATION_BITS{15};
+
+    static u32 GetSlot(Handle handle) {
+        return handle & ((1 << SLOT_BITS) - 1);
+    }
+
+    static u32 GetGeneration(Handle handle) {
+        return handle >> SLOT_BITS;
+    }
+
+    /// Returns the slot of a handle if it's currently valid, or nullptr
+    const SharedPtr<Object>* Find(Handle handle) const;
+
+    /// Objects referenced by each slot, or null for free slots
+    std::array<SharedPtr<Object>, MAX_COUNT> objects{};
+
+    /**
+     * Generation of the handle held by each slot. For free slots, this instead holds the index of
+     * the next free slot, forming a free list.
+     */
+    std::array<u16, MAX_COUNT> generations{};
+
+    /// Generation given to the next created handle. Never 0, so that no handle is 0.
+    u16 next_generation{1};
+
+    /// Head of the free slot list, or MAX_COUNT if the table is full
+    u16 next_free_slot{};
 
     KernelSystem& kernel;
 };
@@ -7,6 +7,7 @@
 #include "common/assert.h"
 #include "common/common_types.h"
 #include "core/core.h"
+#include "core/hle/kernel/async_work.h"
 #include "core/hle/kernel/event.h"
 #include "core/hle/kernel/handle_table.h"
 #include "core/hle/kernel/hle_ipc.h"
@@ -65,6 +66,14 @@ SharedPtr<Event> HLERequestContext::SleepClientThread(SharedPtr<Thread> thread,
     return event;
 }
 
+void HLERequestContext::RunAsync(SharedPtr<Thread> thread, const std::string& reason,
+                                 std::chrono::nanoseconds delay, std::function<void()>&& work,
+                                 WakeupCallback&& callback) {
+    auto event{SleepClientThread(thread, reason, std::chrono::nanoseconds{}, std::move(callback))};
+    thread->system.Kernel().GetAsyncWorkManager().Run(std::move(work), std::move(event),
+                                                      delay.count());
+}
+
 HLERequestContext::HLERequestContext(SharedPtr<ServerSession> session)
     : session{std::move(session)} {
     cmd_buf[0] = 0;
@@ -72,6 +81,38 @@ HLERequestContext::HLERequestContext(SharedPtr<ServerSession> session)
 
 HLERequestContext::~HLERequestContext() = default;
 
+void HLERequestContext::Reset(SharedPtr<ServerSession> session) {
+    this->session = std::move(session);
+    cmd_buf[0] = 0;
+    request_handles.clear();
+    request_mapped_buffers.clear();
+    // clear() keeps the capacity of the vectors
+    for (auto& buffer : static_buffers)
+        buffer.clear();
+}
+
+// Maximum number of idle contexts kept per thread. HLE requests rarely nest, so a few are enough.
+constexpr std::size_t MAX_POOLED_REQUEST_CONTEXTS{4};
+
+static thread_local std::vector<std::unique_ptr<HLERequestContext>> request_context_pool;
+
+std::unique_ptr<HLERequestContext> AcquireRequestContext(SharedPtr<ServerSession> session) {
+    if (request_context_pool.empty())
+        return std::make_unique<HLERequestContext>(std::move(session));
+    auto context{std::move(request_context_pool.back())};
+    request_context_pool.pop_back();
+    context->Reset(std::move(session));
+    return context;
+}
+
+void ReleaseRequestContext(std::unique_ptr<HLERequestContext> context) {
+    if (request_context_pool.size() >= MAX_POOLED_REQUEST_CONTEXTS)
+        return;
+    // Don't keep the objects of the finished request alive while the context is idle
+    context->Reset(nullptr);
+    request_context_pool.push_back(std::move(context));
+}
+
 SharedPtr<Object> HLERequestContext::GetIncomingHandle(u32 id_from_cmdbuf) const {
     ASSERT(id_from_cmdbuf < request_handles.size());
     return request_handles[id_from_cmdbuf];
@@ -129,11 +170,11 @@ ResultCode HLERequestContext::PopulateFromIncomingCommandBuffer(const u32_le* sr
         case IPC::DescriptorType::StaticBuffer: {
             VAddr source_address{src_cmdbuf[i]};
             IPC::StaticBufferDescInfo buffer_info{descriptor};
-            // Copy the input buffer into our own vector and store it.
-            std::vector<u8> data(buffer_info.size);
+            // Copy the input buffer into our own vector, reusing its storage from earlier requests
+            auto& data{static_buffers[buffer_info.buffer_id]};
+            data.resize(buffer_info.size);
             src_process.system.Memory().ReadBlock(src_process, source_address, data.data(),
                                                   data.size());
-            AddStaticBuffer(buffer_info.buffer_id, std::move(data));
             cmd_buf[i++] = source_address;
             break;
         }
@@ -170,9 +211,9 @@ ResultCode HLERequestContext::WriteToOutgoingCommandBuffer(u32_le* dst_cmdbuf,
             for (u32 j{}; j < num_handles; ++j) {
                 auto object{GetIncomingHandle(cmd_buf[i])};
                 Handle handle{};
-                if (object)
-                    // TODO: Figure out the proper error handling for if this fails
-                    handle = dst_process.handle_table.Create(object);
+                if (object) {
+                    CASCADE_RESULT(handle, dst_process.handle_table.Create(object));
+                }
                 dst_cmdbuf[i++] = handle;
             }
             break;
@@ -158,6 +158,12 @@ public:
     HLERequestContext(SharedPtr<ServerSession> session);
     ~HLERequestContext();
 
+    /**
+     * Prepares this context for a new request made through the given session, dropping everything
+     * from the previous request while keeping its buffers allocated.
+     */
+    void Reset(SharedPtr<ServerSession> session);
+
     /// Returns a pointer to the IPC command buffer for this request.
     u32* CommandBuffer() {
         return cmd_buf.data();
@@ -189,6 +195,23 @@ public:
     SharedPtr<Event> SleepClientThread(SharedPtr<Thread> thread, const std::string& reason,
                                        std::chrono::nanoseconds timeout, WakeupCallback&& callback);
 
+    /**
+     * Runs the expensive part of a request on a host worker thread while the specified guest
+     * thread sleeps, letting the other guest threads run meanwhile. Once the given emulated time
+     * passed, the emulation thread waits for the work if it isn't done yet, then resumes the
+     * thread and invokes the callback.
+     * @param thread Thread to be put to sleep.
+     * @param reason Reason for pausing the thread, to be used for debugging purposes.
+     * @param delay Emulated time the request takes.
+     * @param work Work to run on the worker thread. It must not access guest memory, the context
+     * or kernel objects, since the emulation thread keeps running.
+     * @param callback Callback to be invoked when the thread is resumed. Same as for
+     * SleepClientThread, it must write the entire command response.
+     */
+    void RunAsync(SharedPtr<Thread> thread, const std::string& reason,
+                  std::chrono::nanoseconds delay, std::function<void()>&& work,
+                  WakeupCallback&& callback);
+
     /**
      * Resolves a object id from the request command buffer into a pointer to an object. See the
      * "HLE handle protocol" section in the class documentation for more details.
@@ -245,4 +268,13 @@ private:
     boost::container::small_vector<MappedBuffer, 8> request_mapped_buffers;
 };
 
+/**
+ * Takes a request context for the given session from the calling thread's pool of contexts, or
+ * creates one if the pool is empty.
+ */
+std::unique_ptr<HLERequestContext> AcquireRequestContext(SharedPtr<ServerSession> session);
+
+/// Returns a request context to the calling thread's pool so its buffers can be reused
+void ReleaseRequestContext(std::unique_ptr<HLERequestContext> context);
+
 } // namespace Kernel
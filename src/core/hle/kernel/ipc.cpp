@@ -66,8 +66,7 @@ ResultCode TranslateCommandBuffer(SharedPtr<Thread> src_thread, SharedPtr<Thread
                     cmd_buf[i++] = 0;
                     continue;
                 }
-                auto result{dst_process->handle_table.Create(std::move(object))};
-                cmd_buf[i++] = result;
+                CASCADE_RESULT(cmd_buf[i++], dst_process->handle_table.Create(std::move(object)));
             }
             break;
         }
@@ -78,10 +77,8 @@ ResultCode TranslateCommandBuffer(SharedPtr<Thread> src_thread, SharedPtr<Thread
         case IPC::DescriptorType::StaticBuffer: {
             IPC::StaticBufferDescInfo bufferInfo{descriptor};
             VAddr static_buffer_src_address{cmd_buf[i]};
-            std::vector<u8> data(bufferInfo.size);
-            memory.ReadBlock(*src_process, static_buffer_src_address, data.data(), data.size());
             // Grab the address that the target thread set up to receive the response static buffer
-            // and write our data there. The static buffers area is located right after the command
+            // and copy our data there. The static buffers area is located right after the command
             // buffer area.
             struct StaticBuffer {
                 IPC::StaticBufferDescInfo descriptor;
@@ -93,7 +90,8 @@ ResultCode TranslateCommandBuffer(SharedPtr<Thread> src_thread, SharedPtr<Thread
                                                       sizeof(StaticBuffer) * bufferInfo.buffer_id)};
             memory.ReadBlock(*dst_process, dst_address + static_buffer_offset, &target_buffer,
                              sizeof(target_buffer));
-            memory.WriteBlock(*dst_process, target_buffer.address, data.data(), data.size());
+            memory.CopyBlock(*src_process, *dst_process, static_buffer_src_address,
+                             target_buffer.address, bufferInfo.size);
             cmd_buf[i++] = target_buffer.address;
             break;
         }
@@ -123,10 +121,21 @@ ResultCode TranslateCommandBuffer(SharedPtr<Thread> src_thread, SharedPtr<Thread
                                context.target_address == source_address;
                     })};
                 ASSERT(found != mapped_buffer_context.end());
-                if (permissions != IPC::MappedBufferPermissions::R)
-                    // Copy the modified buffer back into the target process
+                if (permissions != IPC::MappedBufferPermissions::R) {
+                    // Copy the modified copied parts back into the target process. The rest was
+                    // written in place, so only the rasterizer cache needs to know about it.
                     memory.CopyBlock(*src_process, *dst_process, found->target_address,
-                                     found->source_address, size);
+                                     found->source_address, found->head_copy_size);
+                    u32 tail_offset{size - found->tail_copy_size};
+                    memory.CopyBlock(*src_process, *dst_process,
+                                     found->target_address + tail_offset,
+                                     found->source_address + tail_offset, found->tail_copy_size);
+                    u32 aliased_size{size - found->head_copy_size - found->tail_copy_size};
+                    if (aliased_size != 0)
+                        memory.RasterizerFlushVirtualRegion(
+                            found->source_address + found->head_copy_size, aliased_size,
+                            Memory::FlushMode::Invalidate);
+                }
                 VAddr prev_reserve{page_start - Memory::PAGE_SIZE};
                 VAddr next_reserve{page_start + num_pages * Memory::PAGE_SIZE};
                 auto& prev_vma{src_process->vm_manager.FindVMA(prev_reserve)->second};
@@ -142,28 +151,71 @@ ResultCode TranslateCommandBuffer(SharedPtr<Thread> src_thread, SharedPtr<Thread
                 break;
             }
             // TODO: Perform permission checks.
-            // Reserve a page of memory before the mapped buffer
+            // Pages only partially covered by the buffer are copied, so the target process can't
+            // see the memory around it. The pages in between are mapped from the source process's
+            // backing memory directly.
+            const bool tail_partial{((page_offset + size) & Memory::PAGE_MASK) != 0};
+            const bool copy_head{page_offset != 0 || (num_pages == 1 && tail_partial)};
+            const bool copy_tail{tail_partial && num_pages > 1};
+            const u32 first_aliased_page{copy_head ? 1u : 0u};
+            const u32 num_aliased_pages{num_pages - first_aliased_page - (copy_tail ? 1 : 0)};
+            const VAddr aliased_address{page_start + first_aliased_page * Memory::PAGE_SIZE};
+            std::vector<std::pair<u8*, u32>> backing_blocks;
+            if (num_aliased_pages != 0) {
+                auto blocks{src_process->vm_manager.GetBackingBlocksForRange(
+                    aliased_address, num_aliased_pages * Memory::PAGE_SIZE)};
+                if (blocks.Succeeded())
+                    backing_blocks = std::move(*blocks);
+            }
+            // Fall back to copying the whole buffer if its pages aren't all backed by memory
+            const bool copy_all{num_aliased_pages != 0 && backing_blocks.empty()};
+            u32 head_pages{copy_all ? num_pages : first_aliased_page};
+            u32 tail_pages{!copy_all && copy_tail ? 1u : 0u};
+            u32 head_copy_size{};
+            if (copy_all)
+                head_copy_size = size;
+            else if (copy_head)
+                head_copy_size = std::min(size, Memory::PAGE_SIZE - page_offset);
+            u32 tail_copy_size{tail_pages != 0 ? (page_offset + size) & Memory::PAGE_MASK : 0u};
+            auto buffer{std::make_unique<u8[]>((head_pages + tail_pages) * Memory::PAGE_SIZE)};
+            memory.ReadBlock(*src_process, source_address, buffer.get() + page_offset,
+                             head_copy_size);
+            u8* tail_buffer{buffer.get() + head_pages * Memory::PAGE_SIZE};
+            memory.ReadBlock(*src_process, source_address + size - tail_copy_size, tail_buffer,
+                             tail_copy_size);
+            // The target process accesses the aliased pages without going through the
+            // rasterizer cache of the source process
+            if (!backing_blocks.empty())
+                memory.RasterizerFlushVirtualRegion(aliased_address,
+                                                    num_aliased_pages * Memory::PAGE_SIZE,
+                                                    Memory::FlushMode::Flush);
+            // Map the page(s) into the target process's address space, between two reserved pages
+            auto& vm_manager{dst_process->vm_manager};
             auto reserve_buffer{std::make_unique<u8[]>(Memory::PAGE_SIZE)};
-            dst_process->vm_manager.MapBackingMemoryToBase(
-                Memory::IPC_MAPPING_VADDR, Memory::IPC_MAPPING_SIZE, reserve_buffer.get(),
-                Memory::PAGE_SIZE, Kernel::MemoryState::Reserved);
-            auto buffer{std::make_unique<u8[]>(num_pages * Memory::PAGE_SIZE)};
-            memory.ReadBlock(*src_process, source_address, buffer.get() + page_offset, size);
-            // Map the page(s) into the target process's address space.
-            VAddr target_address{dst_process->vm_manager
-                                     .MapBackingMemoryToBase(Memory::IPC_MAPPING_VADDR,
-                                                             Memory::IPC_MAPPING_SIZE, buffer.get(),
-                                                             num_pages * Memory::PAGE_SIZE,
-                                                             Kernel::MemoryState::Shared)
-                                     .Unwrap()};
+            VAddr region_start{vm_manager
+                                   .FindFreeRegion(Memory::IPC_MAPPING_VADDR,
+                                                   Memory::IPC_MAPPING_SIZE,
+                                                   (num_pages + 2) * Memory::PAGE_SIZE)
+                                   .Unwrap()};
+            VAddr target_address{region_start + Memory::PAGE_SIZE};
+            vm_manager.MapBackingMemory(region_start, reserve_buffer.get(), Memory::PAGE_SIZE,
+                                        Kernel::MemoryState::Reserved);
+            std::vector<std::pair<u8*, u32>> blocks;
+            blocks.reserve(backing_blocks.size() + 2);
+            if (head_pages != 0)
+                blocks.emplace_back(buffer.get(), head_pages * Memory::PAGE_SIZE);
+            blocks.insert(blocks.end(), backing_blocks.begin(), backing_blocks.end());
+            if (tail_pages != 0)
+                blocks.emplace_back(tail_buffer, Memory::PAGE_SIZE);
+            vm_manager.MapBackingMemoryRange(target_address, blocks, Kernel::MemoryState::Shared);
+            vm_manager.MapBackingMemory(target_address + num_pages * Memory::PAGE_SIZE,
+                                        reserve_buffer.get(), Memory::PAGE_SIZE,
+                                        Kernel::MemoryState::Reserved);
             cmd_buf[i++] = target_address + page_offset;
-            // Reserve a page of memory after the mapped buffer
-            dst_process->vm_manager.MapBackingMemoryToBase(
-                Memory::IPC_MAPPING_VADDR, Memory::IPC_MAPPING_SIZE, reserve_buffer.get(),
-                Memory::PAGE_SIZE, Kernel::MemoryState::Reserved);
             mapped_buffer_context.push_back({permissions, size, source_address,
                                              target_address + page_offset, std::move(buffer),
-                                             std::move(reserve_buffer)});
+                                             std::move(reserve_buffer), head_copy_size,
+                                             tail_copy_size});
             break;
         }
         default:
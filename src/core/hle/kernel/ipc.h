@@ -18,8 +18,13 @@ struct MappedBufferContext {
     VAddr source_address;
     VAddr target_address;
 
+    /// Pages holding the parts of the buffer that were copied instead of being mapped from the
+    /// source process
     std::unique_ptr<u8[]> buffer;
     std::unique_ptr<u8[]> reserve_buffer;
+    /// Sizes of the copied parts at the start and at the end of the buffer
+    u32 head_copy_size;
+    u32 tail_copy_size;
 };
 
 /// Performs IPC command buffer translation from one process to another.
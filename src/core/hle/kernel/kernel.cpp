@@ -2,7 +2,9 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include "common/logging/log.h"
 #include "core/core.h"
+#include "core/hle/kernel/async_work.h"
 #include "core/hle/kernel/client_port.h"
 #include "core/hle/kernel/config_mem.h"
 #include "core/hle/kernel/handle_table.h"
@@ -21,9 +23,20 @@ KernelSystem::KernelSystem(Core::System& system) : system{system} {
     auto& timing{system.CoreTiming()};
     thread_manager = std::make_unique<ThreadManager>(system);
     timer_manager = std::make_unique<TimerManager>(timing);
+    async_work_manager = std::make_unique<AsyncWorkManager>(timing);
 }
 
-KernelSystem::~KernelSystem() = default;
+KernelSystem::~KernelSystem() {
+    static constexpr std::array<const char*, 3> region_names{"Application", "System", "Base"};
+    for (std::size_t i{}; i < memory_regions.size(); ++i) {
+        const auto& stats{memory_regions[i].stats};
+        if (stats.allocations == 0)
+            continue;
+        LOG_INFO(Kernel, "{} memory region: {} allocations ({} failed), {} ns average, {} ns max",
+                 region_names[i], stats.allocations, stats.failures,
+                 stats.total_time.count() / stats.allocations, stats.max_time.count());
+    }
+}
 
 ResourceLimitList& KernelSystem::ResourceLimit() {
     return *resource_limits;
@@ -61,6 +74,10 @@ TimerManager& KernelSystem::GetTimerManager() {
     return *timer_manager;
 }
 
+AsyncWorkManager& KernelSystem::GetAsyncWorkManager() {
+    return *async_work_manager;
+}
+
 const SharedPage::Handler& KernelSystem::GetSharedPageHandler() const {
     return *shared_page_handler;
 }
@@ -30,6 +30,7 @@ class Handler;
 namespace Kernel {
 
 class AddressArbiter;
+class AsyncWorkManager;
 class Event;
 class Mutex;
 class CodeSet;
@@ -218,6 +219,8 @@ public:
     const TimerManager& GetTimerManager() const;
     TimerManager& GetTimerManager();
 
+    AsyncWorkManager& GetAsyncWorkManager();
+
     void MapSharedPages(VMManager& address_space);
 
     const SharedPage::Handler& GetSharedPageHandler() const;
@@ -254,6 +257,9 @@ private:
 
     std::unique_ptr<ThreadManager> thread_manager;
 
+    // Destructed first, so the workers are stopped before the objects their work refers to go away
+    std::unique_ptr<AsyncWorkManager> async_work_manager;
+
     std::unique_ptr<ConfigMem::Handler> config_mem_handler;
     std::unique_ptr<SharedPage::Handler> shared_page_handler;
 
@@ -9,6 +9,7 @@
 #include <utility>
 #include <vector>
 #include "common/assert.h"
+#include "common/bit_set.h"
 #include "common/common_types.h"
 #include "common/logging/log.h"
 #include "core/core.h"
@@ -154,69 +155,184 @@ void KernelSystem::MapSharedPages(VMManager& address_space) {
 }
 
 void MemoryRegionInfo::Reset(u32 base, u32 size) {
+    ASSERT_MSG((base & Memory::PAGE_MASK) == 0, "non-page aligned base: {:08X}", base);
     this->base = base;
     this->size = size;
     used = 0;
-    free_blocks.clear();
+    num_pages = size / Memory::PAGE_SIZE;
+    num_free_pages = 0;
+    const std::size_t num_words{(num_pages + 63) / 64};
+    free_pages.assign(num_words, 0);
+    any_free_words.assign((num_words + 63) / 64, 0);
+    all_free_words.assign((num_words + 63) / 64, 0);
     // Mark the entire region as free
-    free_blocks.insert(Interval::right_open(base, base + size));
+    MarkPages(0, num_pages, true);
 }
 
 MemoryRegionInfo::IntervalSet MemoryRegionInfo::HeapAllocate(u32 size) {
+    const auto start{std::chrono::steady_clock::now()};
+    if ((size + Memory::PAGE_MASK) / Memory::PAGE_SIZE > num_free_pages) {
+        // There is no enough free space
+        RecordAllocation(start, false);
+        return {};
+    }
     IntervalSet result;
     u32 rest{size};
     // Try allocating from the higher address
-    for (auto iter{free_blocks.rbegin()}; iter != free_blocks.rend(); ++iter) {
-        ASSERT(iter->bounds() == boost::icl::interval_bounds::right_open());
-        if (iter->upper() - iter->lower() >= rest) {
-            // Requested size is fulfilled with this block
-            result += Interval(iter->upper() - rest, iter->upper());
-            rest = 0;
-            break;
-        }
-        result += *iter;
-        rest -= iter->upper() - iter->lower();
+    for (u32 end{num_pages}; rest != 0;) {
+        const u32 run_end{FindPrevPage<true>(end)};
+        ASSERT(run_end != 0);
+        const u32 run_start{FindPrevPage<false>(run_end)};
+        // Requested size is fulfilled with this block if it's large enough
+        const u32 block_size{std::min(rest, (run_end - run_start) * Memory::PAGE_SIZE)};
+        const u32 block_pages{(block_size + Memory::PAGE_MASK) / Memory::PAGE_SIZE};
+        const u32 upper{base + run_end * Memory::PAGE_SIZE};
+        result += Interval(upper - block_size, upper);
+        MarkPages(run_end - block_pages, block_pages, false);
+        rest -= block_size;
+        end = run_start;
     }
-    if (rest != 0) {
-        // There is no enough free space
-        return {};
-    }
-    free_blocks -= result;
     used += size;
+    RecordAllocation(start, true);
     return result;
 }
 
 bool MemoryRegionInfo::LinearAllocate(u32 offset, u32 size) {
-    Interval interval{offset, offset + size};
-    if (!boost::icl::contains(free_blocks, interval)) {
+    const auto start{std::chrono::steady_clock::now()};
+    const u32 first{(offset - base) / Memory::PAGE_SIZE};
+    const u32 end{(offset - base + size + Memory::PAGE_MASK) / Memory::PAGE_SIZE};
+    if (offset < base || end > num_pages || FindNextPage<false>(first) < end) {
         // The requested range is already allocated
+        RecordAllocation(start, false);
         return false;
     }
-    free_blocks -= interval;
+    MarkPages(first, end - first, false);
     used += size;
+    RecordAllocation(start, true);
     return true;
 }
 
 std::optional<u32> MemoryRegionInfo::LinearAllocate(u32 size) {
+    const auto start{std::chrono::steady_clock::now()};
+    const u32 pages{(size + Memory::PAGE_MASK) / Memory::PAGE_SIZE};
     // Find the first sufficient continuous block from the lower address
-    for (const auto& interval : free_blocks) {
-        ASSERT(interval.bounds() == boost::icl::interval_bounds::right_open());
-        if (interval.upper() - interval.lower() >= size) {
-            Interval allocated(interval.lower(), interval.lower() + size);
-            free_blocks -= allocated;
+    for (u32 page{FindNextPage<true>(0)}; page < num_pages;) {
+        const u32 run_end{FindNextPage<false>(page)};
+        if (run_end - page >= pages) {
+            MarkPages(page, pages, false);
             used += size;
-            return allocated.lower();
+            RecordAllocation(start, true);
+            return base + page * Memory::PAGE_SIZE;
         }
+        page = FindNextPage<true>(run_end);
     }
     // No sufficient block found
+    RecordAllocation(start, false);
     return {};
 }
 
 void MemoryRegionInfo::Free(u32 offset, u32 size) {
-    Interval interval(offset, offset + size);
-    ASSERT(!boost::icl::intersects(free_blocks, interval)); // Must be allocated blocks
-    free_blocks += interval;
+    ASSERT(offset >= base);
+    const u32 first{(offset - base) / Memory::PAGE_SIZE};
+    const u32 end{(offset - base + size + Memory::PAGE_MASK) / Memory::PAGE_SIZE};
+    ASSERT(end <= num_pages);
+    ASSERT(FindNextPage<true>(first) >= end); // Must be allocated blocks
+    MarkPages(first, end - first, true);
     used -= size;
 }
 
+template <bool free>
+u32 MemoryRegionInfo::FindNextPage(u32 page) const {
+    if (page >= num_pages)
+        return num_pages;
+    // Allocated pages are searched for in the inverted bitmaps. Bits past the end of the region
+    // read as allocated, hence the clamping to the page count.
+    const auto word_bits{[this](std::size_t word) -> u64 {
+        return free ? free_pages[word] : ~free_pages[word];
+    }};
+    const auto summary_bits{[this](std::size_t index) -> u64 {
+        return free ? any_free_words[index] : ~all_free_words[index];
+    }};
+    std::size_t word{page / 64};
+    const u64 bits{word_bits(word) & (~u64{} << (page % 64))};
+    if (bits != 0)
+        return std::min<u32>(num_pages, word * 64 + Common::LeastSignificantSetBit(bits));
+    // Look for the next word with a matching page in the summary
+    ++word;
+    u64 mask{~u64{} << (word % 64)};
+    for (std::size_t index{word / 64}; index < any_free_words.size(); ++index) {
+        const u64 summary{summary_bits(index) & mask};
+        mask = ~u64{};
+        if (summary == 0)
+            continue;
+        const std::size_t next_word{index * 64 + Common::LeastSignificantSetBit(summary)};
+        if (next_word >= free_pages.size())
+            break;
+        return std::min<u32>(num_pages,
+                             next_word * 64 + Common::LeastSignificantSetBit(word_bits(next_word)));
+    }
+    return num_pages;
+}
+
+template <bool free>
+u32 MemoryRegionInfo::FindPrevPage(u32 end) const {
+    if (end == 0)
+        return 0;
+    const auto word_bits{[this](std::size_t word) -> u64 {
+        return free ? free_pages[word] : ~free_pages[word];
+    }};
+    const auto summary_bits{[this](std::size_t index) -> u64 {
+        return free ? any_free_words[index] : ~all_free_words[index];
+    }};
+    const u32 last{end - 1};
+    std::size_t word{last / 64};
+    const u64 bits{word_bits(word) & (~u64{} >> (63 - last % 64))};
+    if (bits != 0)
+        return static_cast<u32>(word * 64 + Common::MostSignificantSetBit(bits) + 1);
+    if (word == 0)
+        return 0;
+    // Look for the previous word with a matching page in the summary
+    --word;
+    u64 mask{~u64{} >> (63 - word % 64)};
+    for (std::size_t index{word / 64 + 1}; index-- > 0;) {
+        const u64 summary{summary_bits(index) & mask};
+        mask = ~u64{};
+        if (summary == 0)
+            continue;
+        const std::size_t prev_word{index * 64 + Common::MostSignificantSetBit(summary)};
+        return static_cast<u32>(prev_word * 64 +
+                                Common::MostSignificantSetBit(word_bits(prev_word)) + 1);
+    }
+    return 0;
+}
+
+void MemoryRegionInfo::MarkPages(u32 first, u32 count, bool free) {
+    const u32 end{first + count};
+    for (u32 page{first}; page < end;) {
+        const std::size_t word{page / 64};
+        const u32 num_bits{std::min(64 - page % 64, end - page)};
+        const u64 mask{(num_bits == 64 ? ~u64{} : (u64{1} << num_bits) - 1) << (page % 64)};
+        u64& bits{free_pages[word]};
+        bits = free ? bits | mask : bits & ~mask;
+        const u64 summary_bit{u64{1} << (word % 64)};
+        u64& any_free{any_free_words[word / 64]};
+        u64& all_free{all_free_words[word / 64]};
+        any_free = bits != 0 ? any_free | summary_bit : any_free & ~summary_bit;
+        all_free = bits == ~u64{} ? all_free | summary_bit : all_free & ~summary_bit;
+        page += num_bits;
+    }
+    num_free_pages = free ? num_free_pages + count : num_free_pages - count;
+}
+
+void MemoryRegionInfo::RecordAllocation(std::chrono::steady_clock::time_point start,
+                                        bool succeeded) {
+    const auto elapsed{std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start)};
+    ++stats.allocations;
+    if (!succeeded)
+        ++stats.failures;
+    stats.total_time += elapsed;
+    stats.max_time = std::max(stats.max_time, elapsed);
+}
+
 } // namespace Kernel
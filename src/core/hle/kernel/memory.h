@@ -4,7 +4,9 @@
 
 #pragma once
 
+#include <chrono>
 #include <optional>
+#include <vector>
 #include <boost/icl/interval_set.hpp>
 #include "common/common_types.h"
 
@@ -26,7 +28,15 @@ struct MemoryRegionInfo {
                                                        /// offsets from start of FCRAM
     using Interval = IntervalSet::interval_type;
 
-    IntervalSet free_blocks;
+    /// Latency statistics of the allocation functions
+    struct AllocationStats {
+        u64 allocations{};
+        u64 failures{};
+        std::chrono::nanoseconds total_time{};
+        std::chrono::nanoseconds max_time{};
+    };
+
+    AllocationStats stats;
 
     /**
      * Reset the allocator state
@@ -64,6 +74,39 @@ struct MemoryRegionInfo {
      * @param size the size of the region to free.
      */
     void Free(u32 offset, u32 size);
+
+private:
+    /**
+     * Finds the first page at or after the given one that is free (or allocated).
+     * @returns the page index relative to the region base, or the page count if there's none.
+     */
+    template <bool free>
+    u32 FindNextPage(u32 page) const;
+
+    /**
+     * Finds the last page before the given one that is free (or allocated).
+     * @returns one past the page index relative to the region base, or 0 if there's none.
+     */
+    template <bool free>
+    u32 FindPrevPage(u32 end) const;
+
+    /// Marks a range of pages, relative to the region base, as free or allocated.
+    void MarkPages(u32 first, u32 count, bool free);
+
+    /// Records the latency of an allocation started at the given time.
+    void RecordAllocation(std::chrono::steady_clock::time_point start, bool succeeded);
+
+    /**
+     * Allocation bitmap with one bit per page of the region, set when the page is free. Two
+     * summary bitmaps with one bit per word, set when the word has any free page and when all its
+     * pages are free respectively, let searches skip over allocated and free runs 4096 pages at a
+     * time. Allocations are page granular; sizes that aren't page aligned take whole pages.
+     */
+    std::vector<u64> free_pages;
+    std::vector<u64> any_free_words;
+    std::vector<u64> all_free_words;
+    u32 num_pages{};
+    u32 num_free_pages{};
 };
 
 void HandleSpecialMapping(Memory::MemorySystem& memory, VMManager& address_space,
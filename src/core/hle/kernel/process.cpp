@@ -165,22 +165,20 @@ ResultVal<VAddr> Process::HeapAllocate(VAddr target, u32 size, VMAPermission per
         LOG_ERROR(Kernel, "Not enough space");
         return ERR_OUT_OF_HEAP_MEMORY;
     }
-    // Maps heap block by block
-    auto interval_target{target};
+    // Maps the whole heap range at once
+    auto& memory{system.Memory()};
+    std::vector<std::pair<u8*, u32>> blocks;
+    blocks.reserve(allocated_fcram.iterative_size());
     for (const auto& interval : allocated_fcram) {
         u32 interval_size{interval.upper() - interval.lower()};
         LOG_DEBUG(Kernel, "Allocated FCRAM region lower={:08X}, upper={:08X}", interval.lower(),
                   interval.upper());
-        auto& memory{system.Memory()};
         std::fill(memory.GetFCRAMPointer(interval.lower()),
                   memory.GetFCRAMPointer(interval.upper()), 0);
-        auto vma{vm_manager.MapBackingMemory(interval_target,
-                                             memory.GetFCRAMPointer(interval.lower()),
-                                             interval_size, memory_state)};
-        ASSERT(vma.Succeeded());
-        vm_manager.Reprotect(vma.Unwrap(), perms);
-        interval_target += interval_size;
+        blocks.emplace_back(memory.GetFCRAMPointer(interval.lower()), interval_size);
     }
+    auto result{vm_manager.MapBackingMemoryRange(target, blocks, memory_state, perms)};
+    ASSERT(result.Succeeded());
     memory_used += size;
     resource_limit->current_commit += size;
     return MakeResult<VAddr>(target);
@@ -299,14 +297,8 @@ ResultCode Process::Map(VAddr target, VAddr source, u32 size, VMAPermission perm
                                               VMAPermission::ReadWrite, source_state, source_perm));
 
     CASCADE_RESULT(auto backing_blocks, vm_manager.GetBackingBlocksForRange(source, size));
-    auto interval_target{target};
-    for (const auto [backing_memory, block_size] : backing_blocks) {
-        auto target_vma{
-            vm_manager.MapBackingMemory(interval_target, backing_memory, block_size, targed_state)};
-        ASSERT(target_vma.Succeeded());
-        vm_manager.Reprotect(target_vma.Unwrap(), perms);
-        interval_target += block_size;
-    }
+    auto target_vma{vm_manager.MapBackingMemoryRange(target, backing_blocks, targed_state, perms)};
+    ASSERT(target_vma.Succeeded());
     return RESULT_SUCCESS;
 }
 
@@ -140,14 +140,9 @@ ResultCode SharedMemory::Map(Process& target_process, VAddr address, MemoryPermi
         return ERR_INVALID_ADDRESS_STATE;
     }
     // Map the memory block into the target process
-    auto interval_target{target_address};
-    for (const auto& interval : backing_blocks) {
-        auto vma{target_process.vm_manager.MapBackingMemory(interval_target, interval.first,
-                                                            interval.second, MemoryState::Shared)};
-        ASSERT(vma.Succeeded());
-        target_process.vm_manager.Reprotect(vma.Unwrap(), ConvertPermissions(permissions));
-        interval_target += interval.second;
-    }
+    auto result{target_process.vm_manager.MapBackingMemoryRange(
+        target_address, backing_blocks, MemoryState::Shared, ConvertPermissions(permissions))};
+    ASSERT(result.Succeeded());
     return RESULT_SUCCESS;
 }
 
@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <functional>
 #include <list>
 #include <unordered_map>
 #include <vector>
@@ -68,15 +69,52 @@ void Thread::Stop() {
     owner_process->tls_slots[tls_page].reset(tls_slot);
 }
 
+// Boost threads that have been ready for longer than this many ticks
+constexpr u64 PRIORITY_BOOST_TIMEOUT{2000000};
+
+bool ThreadManager::StarvationEntry::IsStale() const {
+    return thread->last_running_ticks != last_running_ticks ||
+           thread->status == ThreadStatus::Dead;
+}
+
+void ThreadManager::TrackStarvation(Thread* thread) {
+    starvation_deadlines.push_back({thread->last_running_ticks, thread});
+    std::push_heap(starvation_deadlines.begin(), starvation_deadlines.end(), std::greater<>{});
+}
+
 /// Boost low priority threads (temporarily) that have been starved
 void ThreadManager::PriorityBoostStarvedThreads() {
     u64 current_ticks{system.CoreTiming().GetTicks()};
-    for (auto& thread : thread_list) {
-        const u64 boost_timeout{2000000}; // Boost threads that have been ready for > this long
-        u64 delta{current_ticks - thread->last_running_ticks};
-        if (thread->status == Kernel::ThreadStatus::Ready && delta > boost_timeout) {
+    // Only the threads whose deadline passed since the last reschedule are looked at, instead of
+    // the whole thread list
+    while (!starvation_deadlines.empty() &&
+           current_ticks - starvation_deadlines.front().last_running_ticks >
+               PRIORITY_BOOST_TIMEOUT) {
+        std::pop_heap(starvation_deadlines.begin(), starvation_deadlines.end(), std::greater<>{});
+        auto entry{std::move(starvation_deadlines.back())};
+        starvation_deadlines.pop_back();
+        if (entry.IsStale())
+            continue;
+        starved_threads.push_back(std::move(entry));
+        ++starvation_count;
+    }
+    // Starved threads stay boosted until they run. Threads that are waiting are boosted once
+    // they're ready.
+    starved_threads.erase(std::remove_if(starved_threads.begin(), starved_threads.end(),
+                                         [](const StarvationEntry& entry) {
+                                             return entry.IsStale();
+                                         }),
+                          starved_threads.end());
+    for (auto& entry : starved_threads) {
+        auto& thread{entry.thread};
+        if (thread->status == Kernel::ThreadStatus::Ready) {
             const u32 priority{std::max(ready_queue.get_first()->current_priority - 1, 40u)};
             thread->BoostPriority(priority);
+            // The boost is refreshed on every reschedule, but only counted once
+            if (!entry.boosted) {
+                entry.boosted = true;
+                ++priority_boost_count;
+            }
         }
     }
 }
@@ -87,6 +125,8 @@ void ThreadManager::SwitchContext(Thread* new_thread) {
     // Save context for previous thread
     if (previous_thread) {
         previous_thread->last_running_ticks = timing.GetTicks();
+        if (Settings::values.priority_boost)
+            TrackStarvation(previous_thread);
         system.CPU().SaveContext(previous_thread->context);
         if (previous_thread->status == ThreadStatus::Running) {
             // This is only the case when a reschedule is triggered without the current thread
@@ -276,6 +316,8 @@ ResultVal<SharedPtr<Thread>> KernelSystem::CreateThread(std::string name, VAddr
     thread->stack_top = stack_top;
     thread->nominal_priority = thread->current_priority = priority;
     thread->last_running_ticks = system.CoreTiming().GetTicks();
+    if (Settings::values.priority_boost)
+        thread_manager->TrackStarvation(thread.get());
     thread->processor_id = processor_id;
     thread->wait_objects.clear();
     thread->wait_address = 0;
@@ -406,6 +448,9 @@ ThreadManager::ThreadManager(Core::System& system) : system{system} {
 }
 
 ThreadManager::~ThreadManager() {
+    if (Settings::values.priority_boost)
+        LOG_INFO(Kernel, "Priority boost: {} thread starvations, {} boosts", starvation_count,
+                 priority_boost_count);
     for (auto& t : thread_list)
         t->Stop();
 }
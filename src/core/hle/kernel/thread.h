@@ -89,6 +89,20 @@ public:
     const std::vector<SharedPtr<Thread>>& GetThreadList();
 
 private:
+    /// A thread and the tick it stopped running at, used for starvation tracking
+    struct StarvationEntry {
+        u64 last_running_ticks;
+        SharedPtr<Thread> thread;
+        bool boosted{}; ///< Whether the thread was boosted since it starved
+
+        /// Returns whether the thread ran again since this entry was made
+        bool IsStale() const;
+
+        bool operator>(const StarvationEntry& other) const {
+            return last_running_ticks > other.last_running_ticks;
+        }
+    };
+
     /**
      * Switches the CPU's active thread context to that of the specified thread
      * @param new_thread The thread to switch to
@@ -112,6 +126,9 @@ private:
     /// Boost low priority threads (temporarily) that have been starved
     void PriorityBoostStarvedThreads();
 
+    /// Records that a thread stopped running, so it's checked for starvation once it could be
+    void TrackStarvation(Thread* thread);
+
     u32 next_thread_id{1};
     SharedPtr<Thread> current_thread;
     Common::ThreadQueueList<Thread*, ThreadPrioLowest + 1> ready_queue;
@@ -123,6 +140,17 @@ private:
     // Lists all threads that aren't deleted.
     std::vector<SharedPtr<Thread>> thread_list;
 
+    /// Threads that stopped running, as a min-heap on the tick they stopped running at. Entries
+    /// are moved to starved_threads once the thread could have starved.
+    std::vector<StarvationEntry> starvation_deadlines;
+
+    /// Threads that haven't run since they starved, in the order they starved
+    std::vector<StarvationEntry> starved_threads;
+
+    /// Number of starved threads that were boosted and number of times a thread starved
+    u64 priority_boost_count{};
+    u64 starvation_count{};
+
     Core::System& system;
 
     friend class Thread;
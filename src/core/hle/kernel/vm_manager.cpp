@@ -43,6 +43,7 @@ VMManager::~VMManager() {
 
 void VMManager::Reset() {
     vma_map.clear();
+    last_vma = vma_map.end();
     // Initialize the map with a single free region covering the entire managed space.
     VirtualMemoryArea initial_vma{};
     initial_vma.size = MAX_ADDRESS;
@@ -55,12 +56,15 @@ void VMManager::Reset() {
 VMManager::VMAHandle VMManager::FindVMA(VAddr target) const {
     if (target >= MAX_ADDRESS)
         return vma_map.end();
-    else
-        return std::prev(vma_map.upper_bound(target));
+    // Most lookups land in the same VMA as the previous one (block copies, heap and IPC mappings)
+    if (last_vma != vma_map.end() && target >= last_vma->second.base &&
+        target - last_vma->second.base < last_vma->second.size)
+        return last_vma;
+    last_vma = std::prev(vma_map.upper_bound(target));
+    return last_vma;
 }
 
-ResultVal<VAddr> VMManager::MapBackingMemoryToBase(VAddr base, u32 region_size, u8* memory,
-                                                   u32 size, MemoryState state) {
+ResultVal<VAddr> VMManager::FindFreeRegion(VAddr base, u32 region_size, u32 size) const {
     // Find the first Free VMA.
     auto vma_handle{std::find_if(vma_map.begin(), vma_map.end(), [&](const auto& vma) {
         if (vma.second.type != VMAType::Free)
@@ -68,12 +72,21 @@ ResultVal<VAddr> VMManager::MapBackingMemoryToBase(VAddr base, u32 region_size,
         VAddr vma_end = vma.second.base + vma.second.size;
         return vma_end > base && vma_end >= base + size;
     })};
-    auto target{std::max(base, vma_handle->second.base)};
     // Don't try to allocate the block if there are no available addresses within the desired
     // region.
-    if (vma_handle == vma_map.end() || target + size > base + region_size)
+    if (vma_handle == vma_map.end())
         return ResultCode(ErrorDescription::OutOfMemory, ErrorModule::Kernel,
                           ErrorSummary::OutOfResource, ErrorLevel::Permanent);
+    auto target{std::max(base, vma_handle->second.base)};
+    if (target + size > base + region_size)
+        return ResultCode(ErrorDescription::OutOfMemory, ErrorModule::Kernel,
+                          ErrorSummary::OutOfResource, ErrorLevel::Permanent);
+    return MakeResult<VAddr>(target);
+}
+
+ResultVal<VAddr> VMManager::MapBackingMemoryToBase(VAddr base, u32 region_size, u8* memory,
+                                                   u32 size, MemoryState state) {
+    CASCADE_RESULT(auto target, FindFreeRegion(base, region_size, size));
     auto result{MapBackingMemory(target, memory, size, state)};
     if (result.Failed())
         return result.Code();
@@ -95,6 +108,50 @@ ResultVal<VMManager::VMAHandle> VMManager::MapBackingMemory(VAddr target, u8* me
     return MakeResult<VMAHandle>(MergeAdjacent(vma_handle));
 }
 
+ResultVal<VMManager::VMAHandle> VMManager::MapBackingMemoryRange(
+    VAddr target, const std::vector<std::pair<u8*, u32>>& blocks, MemoryState state,
+    VMAPermission perms) {
+    u32 total_size{};
+    for (const auto& [backing_memory, block_size] : blocks) {
+        ASSERT(backing_memory);
+        total_size += block_size;
+    }
+    // Carve the whole span in one go, then cut it into one VMA per block
+    CASCADE_RESULT(VMAIter vma_handle, CarveVMA(target, total_size));
+    const VMAIter first_vma{vma_handle};
+    VAddr run_base{target};
+    u32 run_size{};
+    u8* run_memory{};
+    for (const auto& [backing_memory, block_size] : blocks) {
+        if (block_size != vma_handle->second.size)
+            SplitVMA(vma_handle, block_size);
+        auto& vma{vma_handle->second};
+        vma.type = VMAType::BackingMemory;
+        vma.permissions = perms;
+        vma.meminfo_state = state;
+        vma.backing_memory = backing_memory;
+        ++vma_handle;
+        // Blocks that are contiguous in host memory share a single page table update
+        if (run_size != 0 && run_memory + run_size != backing_memory) {
+            memory.MapMemoryRegion(page_table, run_base, run_size, run_memory);
+            run_base += run_size;
+            run_size = 0;
+        }
+        if (run_size == 0)
+            run_memory = backing_memory;
+        run_size += block_size;
+    }
+    if (run_size != 0)
+        memory.MapMemoryRegion(page_table, run_base, run_size, run_memory);
+    // Merge the new VMAs with each other and their neighbours. The comparison against the end of
+    // the range must be done using addresses since merging invalidates the iterators.
+    const VAddr target_end{target + total_size};
+    VMAIter vma{MergeAdjacent(first_vma)};
+    for (++vma; vma != vma_map.end() && vma->second.base < target_end; ++vma)
+        vma = MergeAdjacent(vma);
+    return MakeResult<VMAHandle>(FindVMA(target));
+}
+
 ResultVal<VMManager::VMAHandle> VMManager::MapMMIO(VAddr target, PAddr paddr, u32 size,
                                                    MemoryState state,
                                                    Memory::MMIORegionPointer mmio_handler) {
@@ -143,7 +200,6 @@ VMManager::VMAIter VMManager::Unmap(VMAIter vma_handle) {
     vma.meminfo_state = MemoryState::Free;
     vma.backing_memory = nullptr;
     vma.paddr = 0;
-    UpdatePageTableForVMA(vma);
     return MergeAdjacent(vma_handle);
 }
 
@@ -155,6 +211,8 @@ ResultCode VMManager::UnmapRange(VAddr target, u32 size) {
     // merged during this process, causing invalidation of the iterators.
     while (vma != end && vma->second.base < target_end)
         vma = std::next(Unmap(vma));
+    // The range may have been covered by many VMAs, but the page table only needs a single pass
+    memory.UnmapRegion(page_table, target, size);
     ASSERT(FindVMA(target)->second.size >= size);
     return RESULT_SUCCESS;
 }
@@ -270,12 +328,16 @@ VMManager::VMAIter VMManager::MergeAdjacent(VMAIter iter) {
     const VMAIter next_vma{std::next(iter)};
     if (next_vma != vma_map.end() && iter->second.CanBeMergedWith(next_vma->second)) {
         iter->second.size += next_vma->second.size;
+        if (last_vma == next_vma)
+            last_vma = iter;
         vma_map.erase(next_vma);
     }
     if (iter != vma_map.begin()) {
         auto prev_vma{std::prev(iter)};
         if (prev_vma->second.CanBeMergedWith(iter->second)) {
             prev_vma->second.size += iter->second.size;
+            if (last_vma == iter)
+                last_vma = prev_vma;
             vma_map.erase(iter);
             iter = prev_vma;
         }
@@ -113,9 +113,21 @@ public:
     /// Clears the address space map, re-initializing with a single free area.
     void Reset();
 
-    /// Finds the VMA in which the given address is included in, or `vma_map.end()`.
+    /**
+     * Finds the VMA in which the given address is included in, or `vma_map.end()`. The last VMA
+     * found is remembered, so repeated lookups within the same area skip the tree search.
+     */
     VMAHandle FindVMA(VAddr target) const;
 
+    /**
+     * Finds the first free address after the given base where a mapping of the given size fits.
+     * @param base The base address to start the search at.
+     * @param region_size The max size of the region from where we'll try to find an address.
+     * @param size Size of the mapping.
+     * @returns The address at which the memory can be mapped.
+     */
+    ResultVal<VAddr> FindFreeRegion(VAddr base, u32 region_size, u32 size) const;
+
     // TODO: Should these functions actually return the handle?
 
     /**
@@ -139,6 +151,21 @@ public:
      */
     ResultVal<VMAHandle> MapBackingMemory(VAddr target, u8* memory, u32 size, MemoryState state);
 
+    /**
+     * Maps a list of unmanaged host memory blocks back to back starting at a given address. The
+     * whole span is carved out once, and the page table is updated once per run of contiguous host
+     * memory instead of once per block.
+     * @param target The guest address to start the mapping at.
+     * @param blocks The memory blocks to be mapped, with their sizes.
+     * @param state MemoryState tag to attach to the VMAs.
+     * @param perms VMAPermission to give to the VMAs.
+     * @returns The VMA containing the start of the mapping.
+     */
+    ResultVal<VMAHandle> MapBackingMemoryRange(VAddr target,
+                                               const std::vector<std::pair<u8*, u32>>& blocks,
+                                               MemoryState state,
+                                               VMAPermission perms = VMAPermission::ReadWrite);
+
     /**
      * Maps a memory-mapped IO region at a given address.
      * @param target The guest address to start the mapping at.
@@ -189,7 +216,7 @@ private:
     /// Converts a VMAHandle to a mutable VMAIter.
     VMAIter StripIterConstness(const VMAHandle& iter);
 
-    /// Unmaps the given VMA.
+    /// Unmaps the given VMA. The page table isn't updated, that's left to the caller.
     VMAIter Unmap(VMAIter vma);
 
     /**
@@ -220,6 +247,9 @@ private:
     void UpdatePageTableForVMA(const VirtualMemoryArea& vma);
 
     Memory::MemorySystem& memory;
+
+    /// The VMA returned by the last call to FindVMA, or `vma_map.end()`.
+    mutable VMAHandle last_vma;
 };
 
 } // namespace Kernel
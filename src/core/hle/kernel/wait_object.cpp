@@ -30,28 +30,31 @@ void WaitObject::RemoveWaitingThread(Thread* thread) {
         waiting_threads.erase(itr);
 }
 
+bool WaitObject::IsReadyToRun(Thread* thread) const {
+    // The list of waiting threads must not contain threads that aren't waiting to be awakened.
+    ASSERT_MSG(thread->status == ThreadStatus::WaitSynchAny ||
+                   thread->status == ThreadStatus::WaitSynchAll ||
+                   thread->status == ThreadStatus::WaitHleEvent,
+               "Inconsistent thread statuses in waiting_threads");
+    if (ShouldWait(thread))
+        return false;
+    // A thread is ready to run if it's either in ThreadStatus::WaitSynchAny or
+    // in ThreadStatus::WaitSynchAll and the rest of the objects it's waiting on are ready.
+    if (thread->status == ThreadStatus::WaitSynchAll)
+        return std::none_of(thread->wait_objects.begin(), thread->wait_objects.end(),
+                            [thread](const SharedPtr<WaitObject>& object) {
+                                return object->ShouldWait(thread);
+                            });
+    return true;
+}
+
 SharedPtr<Thread> WaitObject::GetHighestPriorityReadyThread() {
     Thread* candidate{};
     u32 candidate_priority{ThreadPrioLowest + 1};
     for (const auto& thread : waiting_threads) {
-        // The list of waiting threads must not contain threads that aren't waiting to be awakened.
-        ASSERT_MSG(thread->status == ThreadStatus::WaitSynchAny ||
-                       thread->status == ThreadStatus::WaitSynchAll ||
-                       thread->status == ThreadStatus::WaitHleEvent,
-                   "Inconsistent thread statuses in waiting_threads");
         if (thread->current_priority >= candidate_priority)
             continue;
-        if (ShouldWait(thread.get()))
-            continue;
-        // A thread is ready to run if it's either in ThreadStatus::WaitSynchAny or
-        // in ThreadStatus::WaitSynchAll and the rest of the objects it's waiting on are ready.
-        bool ready_to_run{true};
-        if (thread->status == ThreadStatus::WaitSynchAll)
-            ready_to_run = std::none_of(thread->wait_objects.begin(), thread->wait_objects.end(),
-                                        [&thread](const SharedPtr<WaitObject>& object) {
-                                            return object->ShouldWait(thread.get());
-                                        });
-        if (ready_to_run) {
+        if (IsReadyToRun(thread.get())) {
             candidate = thread.get();
             candidate_priority = thread->current_priority;
         }
@@ -60,7 +63,20 @@ SharedPtr<Thread> WaitObject::GetHighestPriorityReadyThread() {
 }
 
 void WaitObject::WakeupAllWaitingThreads() {
-    while (auto thread{GetHighestPriorityReadyThread()}) {
+    // Visit the waiting threads once, in priority order. Threads with the same priority keep the
+    // order in which they started waiting, like in the real kernel. Acquiring an object never makes
+    // another thread ready, so threads that aren't ready when they're visited can be skipped.
+    std::vector<SharedPtr<Thread>> candidates{waiting_threads};
+    std::stable_sort(candidates.begin(), candidates.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs->current_priority < rhs->current_priority;
+    });
+    for (auto& thread : candidates) {
+        // Skip threads that were woken up by a callback of an earlier thread. A thread waits on
+        // this object exactly as long as the object is in its wait_objects.
+        const auto& wait_objects{thread->wait_objects};
+        if (std::find(wait_objects.begin(), wait_objects.end(), this) == wait_objects.end() ||
+            !IsReadyToRun(thread.get()))
+            continue;
         if (!thread->IsSleepingOnWaitAll())
             Acquire(thread.get());
         else
@@ -57,7 +57,10 @@ public:
     void SetHLENotifier(std::function<void()> callback);
 
 private:
-    /// Threads waiting for this object to become available
+    /// Returns whether a waiting thread can be woken up by this object
+    bool IsReadyToRun(Thread* thread) const;
+
+    /// Threads waiting for this object to become available, in the order they started waiting
     std::vector<SharedPtr<Thread>> waiting_threads;
 
     /// Function to call when this object becomes available
@@ -37,7 +37,7 @@ void File::Read(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp{ctx, 0x0802, 3, 2};
     u64 offset{rp.Pop<u64>()};
     u32 length{rp.Pop<u32>()};
-    auto& buffer{rp.PopMappedBuffer()};
+    const u32 buffer_id{rp.PopMappedBuffer().GetId()};
     LOG_TRACE(Service_FS, "Read {}: offset=0x{:X} length=0x{:08X}", GetName(), offset, length);
     const FileSessionSlot* file{GetSessionData(ctx.Session())};
     if (file->subfile && length > file->size) {
@@ -46,29 +46,49 @@ void File::Read(Kernel::HLERequestContext& ctx) {
     }
     // This file session might have a specific offset from where to start reading, apply it.
     offset += file->offset;
-    if (offset + length > backend->GetSize())
-        LOG_ERROR(Service_FS,
-                  "Reading from out of bounds offset=0x{:X} length=0x{:08X} file_size=0x{:X}",
-                  offset, length, backend->GetSize());
-    auto rb{rp.MakeBuilder(2, 2)};
-    std::vector<u8> data(length);
-    ResultVal<std::size_t> read{backend->Read(offset, data.size(), data.data())};
-    if (read.Failed()) {
-        rb.Push(read.Code());
-        rb.Push<u32>(0);
-    } else {
-        buffer.Write(data.data(), 0, *read);
-        rb.Push(RESULT_SUCCESS);
-        rb.Push<u32>(static_cast<u32>(*read));
+    std::chrono::nanoseconds read_timeout_ns;
+    {
+        std::lock_guard lock{backend_mutex};
+        if (offset + length > backend->GetSize())
+            LOG_ERROR(Service_FS,
+                      "Reading from out of bounds offset=0x{:X} length=0x{:08X} file_size=0x{:X}",
+                      offset, length, backend->GetSize());
+        read_timeout_ns = std::chrono::nanoseconds{backend->GetReadDelayNs(length)};
     }
-    rb.PushMappedBuffer(buffer);
-    std::chrono::nanoseconds read_timeout_ns{backend->GetReadDelayNs(length)};
-    ctx.SleepClientThread(system.Kernel().GetThreadManager().GetCurrentThread(), "file::read",
-                          read_timeout_ns,
-                          [](Kernel::SharedPtr<Kernel::Thread> thread,
-                             Kernel::HLERequestContext& ctx, Kernel::ThreadWakeupReason reason) {
-                              // Nothing to do here
-                          });
+    // The host read runs on a worker thread, the guest buffer is written once it's done
+    struct ReadResult {
+        std::vector<u8> data;
+        ResultCode code{RESULT_SUCCESS};
+        std::size_t size{};
+    };
+    auto result{std::make_shared<ReadResult>()};
+    result->data.resize(length);
+    auto self{std::static_pointer_cast<File>(shared_from_this())};
+    ctx.RunAsync(
+        system.Kernel().GetThreadManager().GetCurrentThread(), "file::read", read_timeout_ns,
+        [self, result, offset] {
+            std::lock_guard lock{self->backend_mutex};
+            ResultVal<std::size_t> read{
+                self->backend->Read(offset, result->data.size(), result->data.data())};
+            if (read.Failed())
+                result->code = read.Code();
+            else
+                result->size = *read;
+        },
+        [result, buffer_id](Kernel::SharedPtr<Kernel::Thread> thread,
+                            Kernel::HLERequestContext& ctx, Kernel::ThreadWakeupReason reason) {
+            auto& buffer{ctx.GetMappedBuffer(buffer_id)};
+            IPC::ResponseBuilder rb{ctx, 0x0802, 2, 2};
+            if (result->code.IsError()) {
+                rb.Push(result->code);
+                rb.Push<u32>(0);
+            } else {
+                buffer.Write(result->data.data(), 0, result->size);
+                rb.Push(RESULT_SUCCESS);
+                rb.Push<u32>(static_cast<u32>(result->size));
+            }
+            rb.PushMappedBuffer(buffer);
+        });
 }
 
 void File::Write(Kernel::HLERequestContext& ctx) {
@@ -90,6 +110,7 @@ void File::Write(Kernel::HLERequestContext& ctx) {
     }
     std::vector<u8> data(length);
     buffer.Read(data.data(), 0, data.size());
+    std::lock_guard lock{backend_mutex};
     ResultVal<std::size_t> written{backend->Write(offset, data.size(), flush != 0, data.data())};
     if (written.Failed()) {
         rb.Push(written.Code());
@@ -119,6 +140,7 @@ void File::SetSize(Kernel::HLERequestContext& ctx) {
         return;
     }
     file->size = size;
+    std::lock_guard lock{backend_mutex};
     backend->SetSize(size);
     rb.Push(RESULT_SUCCESS);
 }
@@ -128,7 +150,10 @@ void File::Close(Kernel::HLERequestContext& ctx) {
     if (connected_sessions.size() > 1)
         LOG_WARNING(Service_FS, "Closing File backend but {} clients still connected",
                     connected_sessions.size());
-    backend->Close();
+    {
+        std::lock_guard lock{backend_mutex};
+        backend->Close();
+    }
     IPC::ResponseBuilder rb{ctx, 0x0808, 1, 0};
     rb.Push(RESULT_SUCCESS);
 }
@@ -141,7 +166,10 @@ void File::Flush(Kernel::HLERequestContext& ctx) {
         rb.Push(FileSys::ERROR_UNSUPPORTED_OPEN_FLAGS);
         return;
     }
-    backend->Flush();
+    {
+        std::lock_guard lock{backend_mutex};
+        backend->Flush();
+    }
     rb.Push(RESULT_SUCCESS);
 }
 
@@ -171,7 +199,10 @@ void File::OpenLinkFile(Kernel::HLERequestContext& ctx) {
     const FileSessionSlot* original_file{GetSessionData(ctx.Session())};
     slot->priority = original_file->priority;
     slot->offset = 0;
-    slot->size = backend->GetSize();
+    {
+        std::lock_guard lock{backend_mutex};
+        slot->size = backend->GetSize();
+    }
     slot->subfile = false;
     IPC::ResponseBuilder rb{ctx, 0x080C, 1, 2};
     rb.Push(RESULT_SUCCESS);
@@ -222,7 +253,10 @@ Kernel::SharedPtr<Kernel::ClientSession> File::Connect() {
     FileSessionSlot* slot{GetSessionData(server)};
     slot->priority = 0;
     slot->offset = 0;
-    slot->size = backend->GetSize();
+    {
+        std::lock_guard lock{backend_mutex};
+        slot->size = backend->GetSize();
+    }
     slot->subfile = false;
     return std::get<Kernel::SharedPtr<Kernel::ClientSession>>(sessions);
 }
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <mutex>
 #include "core/file_sys/archive_backend.h"
 #include "core/hle/kernel/kernel.h"
 #include "core/hle/service/service.h"
@@ -35,6 +36,7 @@ public:
 
     FileSys::Path path;                            ///< Path of the file
     std::unique_ptr<FileSys::FileBackend> backend; ///< File backend interface
+    std::mutex backend_mutex; ///< Guards the backend, which reads access on worker threads
 
     /// Creates a new session to this File and returns the ClientSession part of the connection.
     Kernel::SharedPtr<Kernel::ClientSession> Connect();
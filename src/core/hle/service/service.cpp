@@ -158,11 +158,12 @@ void ServiceFrameworkBase::ReportUnimplementedFunction(u32* cmd_buf, const Funct
 }
 
 void ServiceFrameworkBase::HandleSyncRequest(SharedPtr<ServerSession> server_session) {
-    auto& kernel{server_session->system.Kernel()};
+    auto& system{server_session->system};
+    auto& kernel{system.Kernel()};
     auto thread{kernel.GetThreadManager().GetCurrentThread()};
     // TODO: avoid GetPointer
     u32* cmd_buf{reinterpret_cast<u32*>(
-        server_session->system.Memory().GetPointer(thread->GetCommandBufferAddress()))};
+        system.Memory().GetPointer(thread->GetCommandBufferAddress()))};
     u32 header_code{cmd_buf[0]};
     auto itr{handlers.find(header_code)};
     const auto info{itr == handlers.end() ? nullptr : &itr->second};
@@ -171,17 +172,24 @@ void ServiceFrameworkBase::HandleSyncRequest(SharedPtr<ServerSession> server_ses
     auto current_process{kernel.GetCurrentProcess()};
     // TODO: The kernel should be the one handling this as part of translation after
     // everything else is migrated
-    Kernel::HLERequestContext context{std::move(server_session)};
-    context.PopulateFromIncomingCommandBuffer(cmd_buf, *current_process);
+    auto context{Kernel::AcquireRequestContext(std::move(server_session))};
+    context->PopulateFromIncomingCommandBuffer(cmd_buf, *current_process);
     LOG_TRACE(Service, "{}", MakeFunctionString(info->name, GetServiceName().c_str(), cmd_buf));
-    handler_invoker(this, info->handler_callback, context);
+    const bool profile{system.perf_stats.IsHLECallProfilingEnabled()};
+    const auto start{profile ? Core::PerfStats::Clock::now()
+                             : Core::PerfStats::Clock::time_point{}};
+    handler_invoker(this, info->handler_callback, *context);
     ASSERT(thread->status == Kernel::ThreadStatus::Running ||
            thread->status == Kernel::ThreadStatus::WaitHleEvent);
     // Only write the response immediately if the thread is still running. If the HLE handler put
     // the thread to sleep then the writing of the command buffer will be deferred to the wakeup
-    // callback.
+    // callback, which holds its own copy of the context.
     if (thread->status == Kernel::ThreadStatus::Running)
-        context.WriteToOutgoingCommandBuffer(cmd_buf, *current_process);
+        context->WriteToOutgoingCommandBuffer(cmd_buf, *current_process);
+    Kernel::ReleaseRequestContext(std::move(context));
+    if (profile)
+        system.perf_stats.AddServiceCallSample(GetServiceName(), header_code, info->name,
+                                               Core::PerfStats::Clock::now() - start);
 }
 
 static bool AttemptLLE(Core::System& system, const ServiceModuleInfo& service_module) {
@@ -11,6 +11,7 @@
 #include "common/logging/log.h"
 #include "common/vector_math.h"
 #include "core/core_timing.h"
+#include "core/cpu/cpu.h"
 #include "core/hle/service/gsp/gsp.h"
 #include "core/hw/gpu.h"
 #include "core/hw/hw.h"
@@ -421,6 +422,7 @@ static void VBlankCallback(u64 userdata, s64 cycles_late) {
     auto gpu{system.ServiceManager().GetService<Service::GSP::GSP_GPU>("gsp::Gpu")};
     gpu->SignalInterrupt(Service::GSP::InterruptID::PDC0);
     gpu->SignalInterrupt(Service::GSP::InterruptID::PDC1);
+    system.CPU().OnVBlank();
     // Reschedule recurrent event
     system.CoreTiming().ScheduleEvent(
         static_cast<u64>(BASE_CLOCK_RATE_ARM11 / Settings::values.screen_refresh_rate) -
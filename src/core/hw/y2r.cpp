@@ -5,7 +5,9 @@
 #include <algorithm>
 #include <array>
 #include <cstddef>
+#include <cstring>
 #include <memory>
+#include <emmintrin.h>
 #include "common/assert.h"
 #include "common/color.h"
 #include "common/common_types.h"
@@ -22,50 +24,102 @@ constexpr std::size_t MAX_TILES{1024 / 8};
 constexpr std::size_t TILE_SIZE{8 * 8};
 using ImageTile = std::array<u32, TILE_SIZE>;
 
-/// Converts a image strip from the source YUV format into individual 8x8 RGB32 tiles.
-static void ConvertYUVToRGB(InputFormat input_format, const u8* input_Y, const u8* input_U,
-                            const u8* input_V, ImageTile output[], unsigned int width,
-                            unsigned int height, const CoefficientSet& coefficients) {
+/// Loads the chroma samples of 8 pixels from a 4:2:2 plane, repeating each sample twice.
+static __m128i LoadChromaPlane(const u8* input) {
+    u32 samples;
+    std::memcpy(&samples, input, sizeof(samples));
+    const __m128i words{
+        _mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(samples)), _mm_setzero_si128())};
+    return _mm_unpacklo_epi16(words, words);
+}
+
+/// Multiplies 8 16-bit samples by a coefficient, producing the exact 32-bit products of the first
+/// and last 4 samples.
+static void Multiply(__m128i samples, __m128i coefficient, __m128i& first, __m128i& last) {
+    const __m128i low{_mm_mullo_epi16(samples, coefficient)};
+    const __m128i high{_mm_mulhi_epi16(samples, coefficient)};
+    first = _mm_unpacklo_epi16(low, high);
+    last = _mm_unpackhi_epi16(low, high);
+}
+
+/// Finishes the fixed point conversion of 8 components and clamps them to 0-255.
+static __m128i FinishComponent(__m128i first, __m128i last, __m128i offset) {
+    first = _mm_srai_epi32(_mm_add_epi32(_mm_srai_epi32(first, 3), offset), 5);
+    last = _mm_srai_epi32(_mm_add_epi32(_mm_srai_epi32(last, 3), offset), 5);
+    // Saturating to 16 and then to unsigned 8 bits clamps to 0-255
+    const __m128i words{_mm_packs_epi32(first, last)};
+    return _mm_packus_epi16(words, words);
+}
+
+/**
+ * Converts a image strip from the source YUV format into individual 8x8 RGB32 tiles. 8 pixels are
+ * converted at a time, which always fall in a single line of a tile since the width is a multiple
+ * of 8. 16-bit formats have already been converted to 8 bits when receiving the data.
+ */
+template <InputFormat input_format>
+static void ConvertYUVToRGB(const u8* input_Y, const u8* input_U, const u8* input_V,
+                            ImageTile output[], unsigned int width, unsigned int height,
+                            const CoefficientSet& coefficients) {
+    // This conversion process is bit-exact with hardware, as far as could be tested:
+    //   r = ((c0 * Y + c1 * V) >> 3) + c5 + 0x18
+    //   g = ((c0 * Y - c2 * V - c3 * U) >> 3) + c6 + 0x18
+    //   b = ((c0 * Y + c4 * U) >> 3) + c7 + 0x18
+    // with each component being clamp(x >> 5, 0, 0xFF).
+    const s32 rounding_offset{0x18};
+    const __m128i c0{_mm_set1_epi16(coefficients[0])};
+    const __m128i c1{_mm_set1_epi16(coefficients[1])};
+    const __m128i c2{_mm_set1_epi16(coefficients[2])};
+    const __m128i c3{_mm_set1_epi16(coefficients[3])};
+    const __m128i c4{_mm_set1_epi16(coefficients[4])};
+    const __m128i r_offset{_mm_set1_epi32(coefficients[5] + rounding_offset)};
+    const __m128i g_offset{_mm_set1_epi32(coefficients[6] + rounding_offset)};
+    const __m128i b_offset{_mm_set1_epi32(coefficients[7] + rounding_offset)};
+    const __m128i zero{_mm_setzero_si128()};
     for (unsigned int y{}; y < height; ++y) {
-        for (unsigned int x{}; x < width; ++x) {
-            s32 Y{};
-            s32 U{};
-            s32 V{};
-            switch (input_format) {
-            case InputFormat::YUV422_Indiv8:
-            case InputFormat::YUV422_Indiv16:
-                Y = input_Y[y * width + x];
-                U = input_U[(y * width + x) / 2];
-                V = input_V[(y * width + x) / 2];
-                break;
-            case InputFormat::YUV420_Indiv8:
-            case InputFormat::YUV420_Indiv16:
-                Y = input_Y[y * width + x];
-                U = input_U[((y / 2) * width + x) / 2];
-                V = input_V[((y / 2) * width + x) / 2];
-                break;
-            case InputFormat::YUYV422_Interleaved:
-                Y = input_Y[(y * width + x) * 2];
-                U = input_Y[(y * width + (x / 2) * 2) * 2 + 1];
-                V = input_Y[(y * width + (x / 2) * 2) * 2 + 3];
-                break;
+        for (unsigned int x{}; x < width; x += 8) {
+            __m128i Y;
+            __m128i U;
+            __m128i V;
+            if constexpr (input_format == InputFormat::YUYV422_Interleaved) {
+                // Y0 U0 Y1 V0 Y2 U1 Y3 V1 ...
+                const __m128i yuyv{_mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(&input_Y[(y * width + x) * 2]))};
+                Y = _mm_and_si128(yuyv, _mm_set1_epi16(0xFF));
+                const __m128i uv{_mm_srli_epi16(yuyv, 8)};
+                U = _mm_and_si128(uv, _mm_set1_epi32(0xFFFF));
+                U = _mm_or_si128(U, _mm_slli_epi32(U, 16));
+                V = _mm_srli_epi32(uv, 16);
+                V = _mm_or_si128(V, _mm_slli_epi32(V, 16));
+            } else {
+                Y = _mm_unpacklo_epi8(
+                    _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&input_Y[y * width + x])),
+                    zero);
+                // 4:2:0 formats share each line of chroma samples between two lines of pixels
+                const unsigned int chroma_y{input_format == InputFormat::YUV420_Indiv8 ? y / 2
+                                                                                       : y};
+                U = LoadChromaPlane(&input_U[(chroma_y * width + x) / 2]);
+                V = LoadChromaPlane(&input_V[(chroma_y * width + x) / 2]);
             }
-            // This conversion process is bit-exact with hardware, as far as could be tested.
-            auto& c{coefficients};
-            s32 cY{c[0] * Y};
-            s32 r{cY + c[1] * V};
-            s32 g{cY - c[2] * V - c[3] * U};
-            s32 b{cY + c[4] * U};
-            const s32 rounding_offset{0x18};
-            r = (r >> 3) + c[5] + rounding_offset;
-            g = (g >> 3) + c[6] + rounding_offset;
-            b = (b >> 3) + c[7] + rounding_offset;
-            unsigned int tile{x / 8};
-            unsigned int tile_x{x % 8};
-            u32* out{&output[tile][y * 8 + tile_x]};
-            *out = ((u32)std::clamp(r >> 5, 0, 0xFF) << 24) |
-                   ((u32)std::clamp(g >> 5, 0, 0xFF) << 16) |
-                   ((u32)std::clamp(b >> 5, 0, 0xFF) << 8);
+            __m128i cY_first, cY_last, c1V_first, c1V_last, c2V_first, c2V_last;
+            __m128i c3U_first, c3U_last, c4U_first, c4U_last;
+            Multiply(Y, c0, cY_first, cY_last);
+            Multiply(V, c1, c1V_first, c1V_last);
+            Multiply(V, c2, c2V_first, c2V_last);
+            Multiply(U, c3, c3U_first, c3U_last);
+            Multiply(U, c4, c4U_first, c4U_last);
+            const __m128i r{FinishComponent(_mm_add_epi32(cY_first, c1V_first),
+                                            _mm_add_epi32(cY_last, c1V_last), r_offset)};
+            const __m128i g{FinishComponent(
+                _mm_sub_epi32(_mm_sub_epi32(cY_first, c2V_first), c3U_first),
+                _mm_sub_epi32(_mm_sub_epi32(cY_last, c2V_last), c3U_last), g_offset)};
+            const __m128i b{FinishComponent(_mm_add_epi32(cY_first, c4U_first),
+                                            _mm_add_epi32(cY_last, c4U_last), b_offset)};
+            // Pack as (r << 24) | (g << 16) | (b << 8)
+            const __m128i zb{_mm_unpacklo_epi8(zero, b)};
+            const __m128i gr{_mm_unpacklo_epi8(g, r)};
+            u32* out{&output[x / 8][y * 8]};
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi16(zb, gr));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4), _mm_unpackhi_epi16(zb, gr));
         }
     }
 }
@@ -154,6 +208,10 @@ static void RotateTile90(const ImageTile& input, ImageTile& output, int height,
 
 static void RotateTile180(const ImageTile& input, ImageTile& output, int height,
                           const u8 out_map[64]) {
+    if (out_map == linear_lut) {
+        std::reverse_copy(input.begin(), input.begin() + height * 8, output.begin());
+        return;
+    }
     int out_i{};
     for (int i{height * 8 - 1}; i >= 0; --i)
         output[out_map[out_i++]] = input[i];
@@ -169,8 +227,7 @@ static void RotateTile270(const ImageTile& input, ImageTile& output, int height,
 
 static void WriteTileToOutput(u32* output, const ImageTile& tile, int height, int line_stride) {
     for (int y{}; y < height; ++y)
-        for (int x{}; x < 8; ++x)
-            output[y * line_stride + x] = tile[y * 8 + x];
+        std::memcpy(&output[y * line_stride], &tile[y * 8], 8 * sizeof(u32));
 }
 
 /**
@@ -279,10 +336,25 @@ void PerformConversion(ConversionConfiguration& cvt, Memory::MemorySystem& memor
             ReceiveData<1>(memory, input_Y, cvt.src_YUYV, row_data_size * 2);
             break;
         }
-        // Note: If additional optimization is required, input_format can be moved to a
-        // template parameter, so that its dispatch can be moved to outside the inner loop.
-        ConvertYUVToRGB(cvt.input_format, input_Y, input_U, input_V, tiles.get(),
-                        cvt.input_line_width, row_height, cvt.coefficients);
+        switch (cvt.input_format) {
+        case InputFormat::YUV422_Indiv8:
+        case InputFormat::YUV422_Indiv16:
+            ConvertYUVToRGB<InputFormat::YUV422_Indiv8>(input_Y, input_U, input_V, tiles.get(),
+                                                        cvt.input_line_width, row_height,
+                                                        cvt.coefficients);
+            break;
+        case InputFormat::YUV420_Indiv8:
+        case InputFormat::YUV420_Indiv16:
+            ConvertYUVToRGB<InputFormat::YUV420_Indiv8>(input_Y, input_U, input_V, tiles.get(),
+                                                        cvt.input_line_width, row_height,
+                                                        cvt.coefficients);
+            break;
+        case InputFormat::YUYV422_Interleaved:
+            ConvertYUVToRGB<InputFormat::YUYV422_Interleaved>(input_Y, input_U, input_V,
+                                                              tiles.get(), cvt.input_line_width,
+                                                              row_height, cvt.coefficients);
+            break;
+        }
 
         u32* output_buffer{reinterpret_cast<u32*>(data_buffer.get())};
         for (std::size_t i{}; i < num_tiles; ++i) {
@@ -290,6 +362,12 @@ void PerformConversion(ConversionConfiguration& cvt, Memory::MemorySystem& memor
             int output_stride{};
             switch (cvt.rotation) {
             case Rotation::None:
+                // Linear tiles are already laid out as the output expects them
+                if (cvt.block_alignment == BlockAlignment::Linear) {
+                    WriteTileToOutput(output_buffer, tiles[i], row_height, cvt.input_line_width);
+                    output_buffer += 8;
+                    continue;
+                }
                 RotateTile0(tiles[i], tmp_tile, row_height, tile_remap);
                 image_strip_width = cvt.input_line_width;
                 output_stride = 8;
@@ -7,6 +7,7 @@
 #include "audio_core/hle/hle.h"
 #include "common/assert.h"
 #include "common/common_types.h"
+#include "common/host_memory.h"
 #include "common/logging/log.h"
 #include "common/swap.h"
 #include "core/core.h"
@@ -20,54 +21,56 @@
 
 namespace Memory {
 
+/// Counts how many rasterizer cache surfaces overlap each page of VRAM and FCRAM
 class RasterizerCacheMarker {
 public:
-    void Mark(VAddr addr, bool cached) {
-        auto p{At(addr)};
-        if (p)
-            *p = cached;
+    /// Returns the counter of a physical page, or nullptr if the page can't be cached
+    u32* AtPhysical(PAddr addr) {
+        if (addr >= VRAM_PADDR && addr < VRAM_PADDR_END)
+            return &vram[(addr - VRAM_PADDR) / PAGE_SIZE];
+        else if (addr >= FCRAM_PADDR && addr < FCRAM_N3DS_PADDR_END)
+            return &fcram[(addr - FCRAM_PADDR) / PAGE_SIZE];
+        return nullptr;
     }
 
     bool IsCached(VAddr addr) {
-        auto p{At(addr)};
-        if (p)
-            return *p;
-        return false;
-    }
-
-private:
-    bool* At(VAddr addr) {
+        const u32* p{nullptr};
         if (addr >= VRAM_VADDR && addr < VRAM_VADDR_END)
-            return &vram[(addr - VRAM_VADDR) / PAGE_SIZE];
+            p = &vram[(addr - VRAM_VADDR) / PAGE_SIZE];
         else if (addr >= LINEAR_HEAP_VADDR && addr < LINEAR_HEAP_VADDR_END)
-            return &linear_heap[(addr - LINEAR_HEAP_VADDR) / PAGE_SIZE];
+            p = &fcram[(addr - LINEAR_HEAP_VADDR) / PAGE_SIZE];
         else if (addr >= NEW_LINEAR_HEAP_VADDR && addr < NEW_LINEAR_HEAP_VADDR_END)
-            return &new_linear_heap[(addr - NEW_LINEAR_HEAP_VADDR) / PAGE_SIZE];
-        return nullptr;
+            p = &fcram[(addr - NEW_LINEAR_HEAP_VADDR) / PAGE_SIZE];
+        return p && *p != 0;
     }
 
-    std::array<bool, VRAM_N3DS_SIZE / PAGE_SIZE> vram{};
-    std::array<bool, LINEAR_HEAP_SIZE / PAGE_SIZE> linear_heap{};
-    std::array<bool, NEW_LINEAR_HEAP_SIZE / PAGE_SIZE> new_linear_heap{};
+private:
+    std::array<u32, VRAM_SIZE / PAGE_SIZE> vram{};
+    std::array<u32, FCRAM_N3DS_SIZE / PAGE_SIZE> fcram{};
 };
 
-struct MemorySystem::Impl {
-    explicit Impl(Core::System& system) : system{system} {
-        std::fill(fcram.get(), fcram.get() + FCRAM_N3DS_SIZE, 0);
-        std::fill(vram.get(), vram.get() + VRAM_N3DS_SIZE, 0);
-        std::fill(n3ds_extra_ram.get(), n3ds_extra_ram.get() + N3DS_EXTRA_RAM_SIZE, 0);
-        std::fill(l2cache.get(), l2cache.get() + L2C_SIZE, 0);
-    }
+// Number of separate CPU-written ranges kept before the rasterizer cache is made to invalidate them
+constexpr std::size_t MAX_PENDING_RASTERIZER_WRITES{256};
 
-    // Visual Studio would try to allocate these on compile time if they are std::array, which would
-    // exceed the memory limit.
-    std::unique_ptr<u8[]> fcram{std::make_unique<u8[]>(FCRAM_N3DS_SIZE)};
-    std::unique_ptr<u8[]> vram{std::make_unique<u8[]>(VRAM_N3DS_SIZE)};
-    std::unique_ptr<u8[]> n3ds_extra_ram{std::make_unique<u8[]>(N3DS_EXTRA_RAM_SIZE)};
+struct MemorySystem::Impl {
+    explicit Impl(Core::System& system) : system{system} {}
+
+    // These are zero-filled lazily by the host, so memory an application never touches (such as
+    // most of the New 3DS FCRAM when emulating an Old 3DS) isn't committed.
+    Common::HostMemory fcram_backing{FCRAM_N3DS_SIZE};
+    Common::HostMemory vram_backing{VRAM_N3DS_SIZE};
+    Common::HostMemory n3ds_extra_ram_backing{N3DS_EXTRA_RAM_SIZE};
+    u8* fcram{fcram_backing.BackingBasePointer()};
+    u8* vram{vram_backing.BackingBasePointer()};
+    u8* n3ds_extra_ram{n3ds_extra_ram_backing.BackingBasePointer()};
+    // Visual Studio would try to allocate this on compile time if it was a std::array
     std::unique_ptr<u8[]> l2cache{std::make_unique<u8[]>(L2C_SIZE)};
 
     PageTable* current_page_table{};
     RasterizerCacheMarker cache_marker;
+    // Physical ranges of rasterizer-cached memory written by the CPU that the rasterizer cache
+    // hasn't invalidated yet. Adjacent writes are merged.
+    std::vector<std::pair<PAddr, u32>> pending_rasterizer_writes;
     std::vector<PageTable*> page_table_list;
     Core::System& system;
 };
@@ -95,12 +98,12 @@ void MemorySystem::MapPages(PageTable& page_table, u32 base, u32 size, u8* memor
         ASSERT_MSG(base < PAGE_TABLE_NUM_ENTRIES, "out of range mapping at {:08X}", base);
         page_table.attributes[base] = type;
         page_table.pointers[base] = memory;
-        base += 1;
         // If the memory to map is already rasterizer-cached, mark the page
         if (type == PageType::Memory && impl->cache_marker.IsCached(base * PAGE_SIZE)) {
             page_table.attributes[base] = PageType::RasterizerCachedMemory;
             page_table.pointers[base] = nullptr;
         }
+        base += 1;
         if (memory)
             memory += PAGE_SIZE;
     }
@@ -134,11 +137,11 @@ void MemorySystem::UnmapRegion(PageTable& page_table, VAddr base, u32 size) {
  */
 u8* MemorySystem::GetPointerForRasterizerCache(VAddr addr) {
     if (addr >= LINEAR_HEAP_VADDR && addr < LINEAR_HEAP_VADDR_END)
-        return impl->fcram.get() + (addr - LINEAR_HEAP_VADDR);
+        return impl->fcram + (addr - LINEAR_HEAP_VADDR);
     else if (addr >= NEW_LINEAR_HEAP_VADDR && addr < NEW_LINEAR_HEAP_VADDR_END)
-        return impl->fcram.get() + (addr - NEW_LINEAR_HEAP_VADDR);
+        return impl->fcram + (addr - NEW_LINEAR_HEAP_VADDR);
     else if (addr >= VRAM_VADDR && addr < VRAM_N3DS_VADDR_END)
-        return impl->vram.get() + (addr - VRAM_VADDR);
+        return impl->vram + (addr - VRAM_VADDR);
     UNREACHABLE();
 }
 
@@ -149,6 +152,8 @@ void MemorySystem::RegisterPageTable(PageTable* page_table) {
 void MemorySystem::UnregisterPageTable(PageTable* page_table) {
     impl->page_table_list.erase(
         std::find(impl->page_table_list.begin(), impl->page_table_list.end(), page_table));
+    if (impl->system.IsCPUInitialized())
+        impl->system.CPU().PageTableRemoved(page_table);
 }
 
 /// This function should only be called for virtual addreses with attribute `PageType::Special`.
@@ -220,7 +225,7 @@ void MemorySystem::Write(const VAddr vaddr, const T data) {
         ASSERT_MSG(false, "Mapped memory page without a pointer @ {:08X}", vaddr);
         break;
     case PageType::RasterizerCachedMemory: {
-        RasterizerFlushVirtualRegion(vaddr, sizeof(T), FlushMode::Invalidate);
+        MarkRasterizerWrite(vaddr, sizeof(T));
         std::memcpy(GetPointerForRasterizerCache(vaddr), &data, sizeof(T));
         break;
     }
@@ -276,22 +281,34 @@ std::string MemorySystem::ReadCString(VAddr vaddr, std::size_t max_length) {
     return string;
 }
 
+struct MemoryArea {
+    PAddr paddr_base;
+    u32 size;
+};
+
+constexpr MemoryArea memory_areas[]{
+    {VRAM_PADDR, VRAM_N3DS_SIZE},   {DSP_RAM_PADDR, DSP_RAM_SIZE},
+    {FCRAM_PADDR, FCRAM_N3DS_SIZE}, {N3DS_EXTRA_RAM_PADDR, N3DS_EXTRA_RAM_SIZE},
+    {L2C_PADDR, L2C_SIZE},
+};
+
+/// Returns the memory area containing an address, or the end of memory_areas if there's none
+static const MemoryArea* FindMemoryArea(PAddr address) {
+    return std::find_if(std::begin(memory_areas), std::end(memory_areas), [&](const auto& area) {
+        // Note: the region end check is inclusive because the user can pass in an address
+        // that represents an open right bound
+        return address >= area.paddr_base && address <= area.paddr_base + area.size;
+    });
+}
+
+bool MemorySystem::IsValidPhysicalRange(PAddr address, u64 size) {
+    const auto area{FindMemoryArea(address)};
+    return area != std::end(memory_areas) &&
+           address - area->paddr_base + size <= static_cast<u64>(area->size);
+}
+
 u8* MemorySystem::GetPhysicalPointer(PAddr address) {
-    struct MemoryArea {
-        PAddr paddr_base;
-        u32 size;
-    };
-    constexpr MemoryArea memory_areas[]{
-        {VRAM_PADDR, VRAM_N3DS_SIZE},   {DSP_RAM_PADDR, DSP_RAM_SIZE},
-        {FCRAM_PADDR, FCRAM_N3DS_SIZE}, {N3DS_EXTRA_RAM_PADDR, N3DS_EXTRA_RAM_SIZE},
-        {L2C_PADDR, L2C_SIZE},
-    };
-    const auto area{
-        std::find_if(std::begin(memory_areas), std::end(memory_areas), [&](const auto& area) {
-            // Note: the region end check is inclusive because the user can pass in an address
-            // that represents an open right bound
-            return address >= area.paddr_base && address <= area.paddr_base + area.size;
-        })};
+    const auto area{FindMemoryArea(address)};
     if (area == std::end(memory_areas)) {
         LOG_ERROR(HW_Memory, "unknown GetPhysicalPointer @ 0x{:08X}", address);
         return nullptr;
@@ -300,16 +317,16 @@ u8* MemorySystem::GetPhysicalPointer(PAddr address) {
     u8* target_pointer;
     switch (area->paddr_base) {
     case VRAM_PADDR:
-        target_pointer = impl->vram.get() + offset_into_region;
+        target_pointer = impl->vram + offset_into_region;
         break;
     case DSP_RAM_PADDR:
         target_pointer = impl->system.DSP().GetDspMemory().data() + offset_into_region;
         break;
     case FCRAM_PADDR:
-        target_pointer = impl->fcram.get() + offset_into_region;
+        target_pointer = impl->fcram + offset_into_region;
         break;
     case N3DS_EXTRA_RAM_PADDR:
-        target_pointer = impl->n3ds_extra_ram.get() + offset_into_region;
+        target_pointer = impl->n3ds_extra_ram + offset_into_region;
         break;
     case L2C_PADDR:
         target_pointer = impl->l2cache.get() + offset_into_region;
@@ -320,71 +337,140 @@ u8* MemorySystem::GetPhysicalPointer(PAddr address) {
     return target_pointer;
 }
 
-/// For a rasterizer-accessible PAddr, gets a list of all possible VAddr
-static std::vector<VAddr> PhysicalToVirtualAddressForRasterizer(PAddr addr) {
-    if (addr >= VRAM_PADDR && addr < VRAM_PADDR_END)
-        return {addr - VRAM_PADDR + VRAM_VADDR};
-    else if (addr >= FCRAM_PADDR && addr < FCRAM_PADDR_END)
-        return {addr - FCRAM_PADDR + LINEAR_HEAP_VADDR, addr - FCRAM_PADDR + NEW_LINEAR_HEAP_VADDR};
-    else if (addr >= FCRAM_PADDR_END && addr < FCRAM_N3DS_PADDR_END)
-        return {addr - FCRAM_PADDR + NEW_LINEAR_HEAP_VADDR};
+void MemorySystem::RasterizerMarkRegionCached(PAddr start, u32 size, bool cached) {
+    if (start == 0 || size == 0)
+        return;
+    const PAddr first_page{start >> PAGE_BITS};
+    const PAddr end_page{((start + size - 1) >> PAGE_BITS) + 1};
+    // Only pages whose count changes from or to zero change their page type. They are collected
+    // in physically contiguous runs, so the page tables are updated one span at a time.
+    PAddr run_start{};
+    u32 run_pages{};
+    bool invalid{};
+    for (PAddr page{first_page}; page != end_page; ++page) {
+        auto count{impl->cache_marker.AtPhysical(page << PAGE_BITS)};
+        bool changed{};
+        if (!count)
+            invalid = true;
+        else if (cached)
+            changed = (*count)++ == 0;
+        else {
+            ASSERT_MSG(*count != 0, "Uncaching page {:08X} that isn't cached", page << PAGE_BITS);
+            changed = --*count == 0;
+        }
+        if (changed && run_pages != 0) {
+            ++run_pages;
+            continue;
+        }
+        if (run_pages != 0)
+            MarkPhysicalRunCached(run_start << PAGE_BITS, run_pages, cached);
+        run_start = page;
+        run_pages = changed ? 1 : 0;
+    }
+    if (run_pages != 0)
+        MarkPhysicalRunCached(run_start << PAGE_BITS, run_pages, cached);
     // While the physical <-> virtual mapping is 1:1 for the regions supported by the cache,
     // some games (like Pokémon Super Mystery Dungeon) will try to use textures that go beyond
     // the end address of VRAM, causing the Virtual->Physical translation to fail when flushing
     // parts of the texture.
-    LOG_ERROR(HW_Memory, "Trying to use invalid physical address for rasterizer: {:08X}", addr);
-    return {};
+    if (invalid)
+        LOG_ERROR(HW_Memory, "Trying to use invalid physical address for rasterizer: {:08X}-{:08X}",
+                  start, start + size);
 }
 
-void MemorySystem::RasterizerMarkRegionCached(PAddr start, u32 size, bool cached) {
-    if (start == 0)
+void MemorySystem::MarkPhysicalRunCached(PAddr start, u32 num_pages, bool cached) {
+    // Every virtual alias of the run is updated in each page table
+    if (start >= VRAM_PADDR && start < VRAM_PADDR_END) {
+        u32 offset{start - VRAM_PADDR};
+        MarkVirtualRunCached(VRAM_VADDR + offset, impl->vram + offset, num_pages, cached);
         return;
-    u32 num_pages{((start + size - 1) >> PAGE_BITS) - (start >> PAGE_BITS) + 1};
-    auto paddr{start};
-    for (unsigned i{}; i < num_pages; ++i, paddr += PAGE_SIZE) {
-        for (const auto& vaddr : PhysicalToVirtualAddressForRasterizer(paddr)) {
-            impl->cache_marker.Mark(vaddr, cached);
-            for (auto page_table : impl->page_table_list) {
-                auto& page_type{page_table->attributes[vaddr >> PAGE_BITS]};
-                if (cached)
-                    // Switch page type to cached if now cached
-                    switch (page_type) {
-                    case PageType::Memory:
-                        page_type = PageType::RasterizerCachedMemory;
-                        page_table->pointers[vaddr >> PAGE_BITS] = nullptr;
-                        break;
-                    default:
-                        break;
-                    }
-                else
-                    // Switch page type to uncached if now uncached
-                    switch (page_type) {
-                    case PageType::RasterizerCachedMemory:
-                        page_type = PageType::Memory;
-                        page_table->pointers[vaddr >> PAGE_BITS] =
-                            GetPointerForRasterizerCache(vaddr & ~PAGE_MASK);
-                        break;
-                    default:
-                        break;
-                    }
+    }
+    u32 offset{start - FCRAM_PADDR};
+    if (start < FCRAM_PADDR_END) {
+        u32 old_heap_pages{std::min(num_pages, (FCRAM_PADDR_END - start) >> PAGE_BITS)};
+        MarkVirtualRunCached(LINEAR_HEAP_VADDR + offset, impl->fcram + offset, old_heap_pages,
+                             cached);
+    }
+    MarkVirtualRunCached(NEW_LINEAR_HEAP_VADDR + offset, impl->fcram + offset, num_pages, cached);
+}
+
+void MemorySystem::MarkVirtualRunCached(VAddr start, u8* host, u32 num_pages, bool cached) {
+    const u32 first{start >> PAGE_BITS};
+    const u32 end{first + num_pages};
+    for (auto page_table : impl->page_table_list) {
+        for (u32 page{first}; page != end; ++page) {
+            auto& page_type{page_table->attributes[page]};
+            if (cached && page_type == PageType::Memory) {
+                // Switch page type to cached if now cached
+                page_type = PageType::RasterizerCachedMemory;
+                page_table->pointers[page] = nullptr;
+            } else if (!cached && page_type == PageType::RasterizerCachedMemory) {
+                // Switch page type to uncached if now uncached
+                page_type = PageType::Memory;
+                page_table->pointers[page] = host + (page - first) * PAGE_SIZE;
             }
         }
     }
 }
 
+void MemorySystem::MarkRasterizerWrite(VAddr vaddr, u32 size) {
+    PAddr paddr;
+    if (vaddr >= LINEAR_HEAP_VADDR && vaddr < LINEAR_HEAP_VADDR_END)
+        paddr = vaddr - LINEAR_HEAP_VADDR + FCRAM_PADDR;
+    else if (vaddr >= NEW_LINEAR_HEAP_VADDR && vaddr < NEW_LINEAR_HEAP_VADDR_END)
+        paddr = vaddr - NEW_LINEAR_HEAP_VADDR + FCRAM_PADDR;
+    else if (vaddr >= VRAM_VADDR && vaddr < VRAM_N3DS_VADDR_END)
+        paddr = vaddr - VRAM_VADDR + VRAM_PADDR;
+    else
+        return;
+    auto& pending{impl->pending_rasterizer_writes};
+    if (!pending.empty()) {
+        auto& [last_start, last_size]{pending.back()};
+        // Streaming writes are usually sequential, so they extend the last range
+        if (paddr <= last_start + last_size && last_start <= paddr + size) {
+            const PAddr end{std::max(last_start + last_size, paddr + size)};
+            last_start = std::min(last_start, paddr);
+            last_size = end - last_start;
+            return;
+        }
+    }
+    pending.emplace_back(paddr, size);
+    if (pending.size() >= MAX_PENDING_RASTERIZER_WRITES)
+        RasterizerInvalidatePendingWrites();
+}
+
+void MemorySystem::RasterizerInvalidatePendingWrites() {
+    auto& pending{impl->pending_rasterizer_writes};
+    if (pending.empty())
+        return;
+    // Since pages are unmapped on shutdown after video core is shutdown, the renderer may be
+    // null here
+    if (VideoCore::g_renderer) {
+        auto rasterizer{VideoCore::g_renderer->GetRasterizer()};
+        for (const auto& [start, size] : pending)
+            rasterizer->InvalidateRegion(start, size);
+    }
+    pending.clear();
+}
+
 void MemorySystem::RasterizerFlushRegion(PAddr start, u32 size) {
+    // Pending CPU writes are newer than the cached data, so they're invalidated before anything is
+    // flushed over them
+    RasterizerInvalidatePendingWrites();
     if (!VideoCore::g_renderer)
         return;
     VideoCore::g_renderer->GetRasterizer()->FlushRegion(start, size);
 }
 
 void MemorySystem::RasterizerInvalidateRegion(PAddr start, u32 size) {
+    RasterizerInvalidatePendingWrites();
     if (!VideoCore::g_renderer)
         return;
     VideoCore::g_renderer->GetRasterizer()->InvalidateRegion(start, size);
 }
 
 void MemorySystem::RasterizerFlushAndInvalidateRegion(PAddr start, u32 size) {
+    RasterizerInvalidatePendingWrites();
     // Since pages are unmapped on shutdown after video core is shutdown, the renderer may be
     // null here
     if (!VideoCore::g_renderer)
@@ -393,6 +479,7 @@ void MemorySystem::RasterizerFlushAndInvalidateRegion(PAddr start, u32 size) {
 }
 
 void MemorySystem::RasterizerFlushVirtualRegion(VAddr start, u32 size, FlushMode mode) {
+    RasterizerInvalidatePendingWrites();
     // Since pages are unmapped on shutdown after video core is shutdown, the renderer may be
     // null here
     if (!VideoCore::g_renderer)
@@ -440,49 +527,79 @@ u64 MemorySystem::Read64(const VAddr addr) {
     return Read<u64_le>(addr);
 }
 
-void MemorySystem::ReadBlock(const Kernel::Process& process, const VAddr src_addr,
-                             void* dest_buffer, const std::size_t size) {
-    auto& page_table{process.vm_manager.page_table};
-    std::size_t remaining_size{size};
-    std::size_t page_index{src_addr >> PAGE_BITS};
-    std::size_t page_offset{src_addr & PAGE_MASK};
-    while (remaining_size > 0) {
-        const std::size_t copy_amount{std::min(PAGE_SIZE - page_offset, remaining_size)};
-        const VAddr current_vaddr{static_cast<VAddr>((page_index << PAGE_BITS) + page_offset)};
-        switch (page_table.attributes[page_index]) {
-        case PageType::Unmapped:
-            LOG_ERROR(HW_Memory,
-                      "unmapped ReadBlock @ 0x{:08X} (start address = 0x{:08X}, size = {})",
-                      current_vaddr, src_addr, size);
-            std::memset(dest_buffer, 0, copy_amount);
-            break;
-        case PageType::Memory: {
+template <typename Func>
+void MemorySystem::WalkBlock(const PageTable& page_table, const VAddr start, const std::size_t size,
+                             Func&& func) {
+    auto PagePointer{[&](std::size_t page_index, PageType type) -> u8* {
+        switch (type) {
+        case PageType::Memory:
             DEBUG_ASSERT(page_table.pointers[page_index]);
-            const u8* src_ptr{page_table.pointers[page_index] + page_offset};
-            std::memcpy(dest_buffer, src_ptr, copy_amount);
-            break;
-        }
-        case PageType::Special: {
-            auto handler{GetMMIOHandler(page_table, current_vaddr)};
-            DEBUG_ASSERT(handler);
-            handler->ReadBlock(current_vaddr, dest_buffer, copy_amount);
-            break;
-        }
+            return page_table.pointers[page_index];
         case PageType::RasterizerCachedMemory:
-            RasterizerFlushVirtualRegion(current_vaddr, static_cast<u32>(copy_amount),
-                                         FlushMode::Flush);
-            std::memcpy(dest_buffer, GetPointerForRasterizerCache(current_vaddr), copy_amount);
-            break;
+            return GetPointerForRasterizerCache(static_cast<VAddr>(page_index << PAGE_BITS));
         default:
-            UNREACHABLE();
+            return nullptr;
         }
-        page_index++;
-        page_offset = 0;
-        dest_buffer = static_cast<u8*>(dest_buffer) + copy_amount;
-        remaining_size -= copy_amount;
+    }};
+    VAddr addr{start};
+    std::size_t remaining_size{size};
+    while (remaining_size > 0) {
+        const std::size_t page_index{addr >> PAGE_BITS};
+        const PageType type{page_table.attributes[page_index]};
+        u8* const page_pointer{PagePointer(page_index, type)};
+        std::size_t run_size{
+            std::min<std::size_t>(PAGE_SIZE - (addr & PAGE_MASK), remaining_size)};
+        // MMIO pages are handled one at a time, as each may belong to a different handler
+        if (type != PageType::Special) {
+            std::size_t next_index{page_index + 1};
+            while (run_size < remaining_size && page_table.attributes[next_index] == type &&
+                   (!page_pointer ||
+                    PagePointer(next_index, type) ==
+                        page_pointer + (next_index - page_index) * PAGE_SIZE)) {
+                run_size = std::min(run_size + PAGE_SIZE, remaining_size);
+                ++next_index;
+            }
+        }
+        func(type, addr, page_pointer ? page_pointer + (addr & PAGE_MASK) : nullptr, run_size);
+        addr += static_cast<VAddr>(run_size);
+        remaining_size -= run_size;
     }
 }
 
+void MemorySystem::ReadBlock(const Kernel::Process& process, const VAddr src_addr,
+                             void* dest_buffer, const std::size_t size) {
+    auto& page_table{process.vm_manager.page_table};
+    WalkBlock(page_table, src_addr, size,
+              [&](PageType type, VAddr current_vaddr, const u8* src_ptr, std::size_t copy_amount) {
+                  switch (type) {
+                  case PageType::Unmapped:
+                      LOG_ERROR(
+                          HW_Memory,
+                          "unmapped ReadBlock @ 0x{:08X} (start address = 0x{:08X}, size = {})",
+                          current_vaddr, src_addr, size);
+                      std::memset(dest_buffer, 0, copy_amount);
+                      break;
+                  case PageType::Memory:
+                      std::memcpy(dest_buffer, src_ptr, copy_amount);
+                      break;
+                  case PageType::Special: {
+                      auto handler{GetMMIOHandler(page_table, current_vaddr)};
+                      DEBUG_ASSERT(handler);
+                      handler->ReadBlock(current_vaddr, dest_buffer, copy_amount);
+                      break;
+                  }
+                  case PageType::RasterizerCachedMemory:
+                      RasterizerFlushVirtualRegion(current_vaddr, static_cast<u32>(copy_amount),
+                                                   FlushMode::Flush);
+                      std::memcpy(dest_buffer, src_ptr, copy_amount);
+                      break;
+                  default:
+                      UNREACHABLE();
+                  }
+                  dest_buffer = static_cast<u8*>(dest_buffer) + copy_amount;
+              });
+}
+
 void MemorySystem::Write8(const VAddr addr, const u8 data) {
     Write<u8>(addr, data);
 }
@@ -502,184 +619,107 @@ void MemorySystem::Write64(const VAddr addr, const u64 data) {
 void MemorySystem::WriteBlock(const Kernel::Process& process, const VAddr dest_addr,
                               const void* src_buffer, const std::size_t size) {
     auto& page_table{process.vm_manager.page_table};
-    std::size_t remaining_size{size};
-    std::size_t page_index{dest_addr >> PAGE_BITS};
-    std::size_t page_offset{dest_addr & PAGE_MASK};
-    while (remaining_size > 0) {
-        const std::size_t copy_amount{std::min(PAGE_SIZE - page_offset, remaining_size)};
-        const VAddr current_vaddr{static_cast<VAddr>((page_index << PAGE_BITS) + page_offset)};
-        switch (page_table.attributes[page_index]) {
-        case PageType::Unmapped:
-            LOG_ERROR(HW_Memory,
-                      "unmapped WriteBlock @ 0x{:08X} (start address = 0x{:08X}, size = {})",
-                      current_vaddr, dest_addr, size);
-            break;
-        case PageType::Memory: {
-            DEBUG_ASSERT(page_table.pointers[page_index]);
-            u8* dest_ptr{page_table.pointers[page_index] + page_offset};
-            std::memcpy(dest_ptr, src_buffer, copy_amount);
-            break;
-        }
-        case PageType::Special: {
-            MMIORegionPointer handler{GetMMIOHandler(page_table, current_vaddr)};
-            DEBUG_ASSERT(handler);
-            handler->WriteBlock(current_vaddr, src_buffer, copy_amount);
-            break;
-        }
-        case PageType::RasterizerCachedMemory:
-            RasterizerFlushVirtualRegion(current_vaddr, static_cast<u32>(copy_amount),
-                                         FlushMode::Invalidate);
-            std::memcpy(GetPointerForRasterizerCache(current_vaddr), src_buffer, copy_amount);
-            break;
-        default:
-            UNREACHABLE();
-        }
-        page_index++;
-        page_offset = 0;
-        src_buffer = static_cast<const u8*>(src_buffer) + copy_amount;
-        remaining_size -= copy_amount;
-    }
+    WalkBlock(page_table, dest_addr, size,
+              [&](PageType type, VAddr current_vaddr, u8* dest_ptr, std::size_t copy_amount) {
+                  switch (type) {
+                  case PageType::Unmapped:
+                      LOG_ERROR(
+                          HW_Memory,
+                          "unmapped WriteBlock @ 0x{:08X} (start address = 0x{:08X}, size = {})",
+                          current_vaddr, dest_addr, size);
+                      break;
+                  case PageType::Memory:
+                      std::memcpy(dest_ptr, src_buffer, copy_amount);
+                      break;
+                  case PageType::Special: {
+                      MMIORegionPointer handler{GetMMIOHandler(page_table, current_vaddr)};
+                      DEBUG_ASSERT(handler);
+                      handler->WriteBlock(current_vaddr, src_buffer, copy_amount);
+                      break;
+                  }
+                  case PageType::RasterizerCachedMemory:
+                      MarkRasterizerWrite(current_vaddr, static_cast<u32>(copy_amount));
+                      std::memcpy(dest_ptr, src_buffer, copy_amount);
+                      break;
+                  default:
+                      UNREACHABLE();
+                  }
+                  src_buffer = static_cast<const u8*>(src_buffer) + copy_amount;
+              });
 }
 
 void MemorySystem::ZeroBlock(const Kernel::Process& process, const VAddr dest_addr,
                              const std::size_t size) {
     auto& page_table{process.vm_manager.page_table};
-    std::size_t remaining_size{size};
-    std::size_t page_index{dest_addr >> PAGE_BITS};
-    std::size_t page_offset{dest_addr & PAGE_MASK};
     static const std::array<u8, PAGE_SIZE> zeros = {};
-    while (remaining_size > 0) {
-        const std::size_t copy_amount{std::min(PAGE_SIZE - page_offset, remaining_size)};
-        const VAddr current_vaddr{static_cast<VAddr>((page_index << PAGE_BITS) + page_offset)};
-        switch (page_table.attributes[page_index]) {
-        case PageType::Unmapped:
-            LOG_ERROR(HW_Memory,
-                      "unmapped ZeroBlock @ 0x{:08X} (start address = 0x{:08X}, size = {})",
-                      current_vaddr, dest_addr, size);
-            break;
-        case PageType::Memory: {
-            DEBUG_ASSERT(page_table.pointers[page_index]);
-            u8* dest_ptr{page_table.pointers[page_index] + page_offset};
-            std::memset(dest_ptr, 0, copy_amount);
-            break;
-        }
-        case PageType::Special: {
-            MMIORegionPointer handler{GetMMIOHandler(page_table, current_vaddr)};
-            DEBUG_ASSERT(handler);
-            handler->WriteBlock(current_vaddr, zeros.data(), copy_amount);
-            break;
-        }
-        case PageType::RasterizerCachedMemory:
-            RasterizerFlushVirtualRegion(current_vaddr, static_cast<u32>(copy_amount),
-                                         FlushMode::Invalidate);
-            std::memset(GetPointerForRasterizerCache(current_vaddr), 0, copy_amount);
-            break;
-        default:
-            UNREACHABLE();
-        }
-        page_index++;
-        page_offset = 0;
-        remaining_size -= copy_amount;
-    }
+    WalkBlock(page_table, dest_addr, size,
+              [&](PageType type, VAddr current_vaddr, u8* dest_ptr, std::size_t copy_amount) {
+                  switch (type) {
+                  case PageType::Unmapped:
+                      LOG_ERROR(
+                          HW_Memory,
+                          "unmapped ZeroBlock @ 0x{:08X} (start address = 0x{:08X}, size = {})",
+                          current_vaddr, dest_addr, size);
+                      break;
+                  case PageType::Memory:
+                      std::memset(dest_ptr, 0, copy_amount);
+                      break;
+                  case PageType::Special: {
+                      MMIORegionPointer handler{GetMMIOHandler(page_table, current_vaddr)};
+                      DEBUG_ASSERT(handler);
+                      handler->WriteBlock(current_vaddr, zeros.data(), copy_amount);
+                      break;
+                  }
+                  case PageType::RasterizerCachedMemory:
+                      MarkRasterizerWrite(current_vaddr, static_cast<u32>(copy_amount));
+                      std::memset(dest_ptr, 0, copy_amount);
+                      break;
+                  default:
+                      UNREACHABLE();
+                  }
+              });
 }
 
 void MemorySystem::CopyBlock(const Kernel::Process& process, VAddr dest_addr, VAddr src_addr,
                              const std::size_t size) {
-    auto& page_table{process.vm_manager.page_table};
-    std::size_t remaining_size{size};
-    std::size_t page_index{src_addr >> PAGE_BITS};
-    std::size_t page_offset{src_addr & PAGE_MASK};
-    while (remaining_size > 0) {
-        const std::size_t copy_amount{std::min(PAGE_SIZE - page_offset, remaining_size)};
-        const VAddr current_vaddr{static_cast<VAddr>((page_index << PAGE_BITS) + page_offset)};
-        switch (page_table.attributes[page_index]) {
-        case PageType::Unmapped: {
-            LOG_ERROR(HW_Memory,
-                      "unmapped CopyBlock @ 0x{:08X} (start address = 0x{:08X}, size = {})",
-                      current_vaddr, src_addr, size);
-            ZeroBlock(process, dest_addr, copy_amount);
-            break;
-        }
-        case PageType::Memory: {
-            DEBUG_ASSERT(page_table.pointers[page_index]);
-            const u8* src_ptr{page_table.pointers[page_index] + page_offset};
-            WriteBlock(process, dest_addr, src_ptr, copy_amount);
-            break;
-        }
-        case PageType::Special: {
-            auto handler{GetMMIOHandler(page_table, current_vaddr)};
-            DEBUG_ASSERT(handler);
-            std::vector<u8> buffer(copy_amount);
-            handler->ReadBlock(current_vaddr, buffer.data(), buffer.size());
-            WriteBlock(process, dest_addr, buffer.data(), buffer.size());
-            break;
-        }
-        case PageType::RasterizerCachedMemory: {
-            RasterizerFlushVirtualRegion(current_vaddr, static_cast<u32>(copy_amount),
-                                         FlushMode::Flush);
-            WriteBlock(process, dest_addr, GetPointerForRasterizerCache(current_vaddr),
-                       copy_amount);
-            break;
-        }
-        default:
-            UNREACHABLE();
-        }
-        page_index++;
-        page_offset = 0;
-        dest_addr += static_cast<VAddr>(copy_amount);
-        src_addr += static_cast<VAddr>(copy_amount);
-        remaining_size -= copy_amount;
-    }
+    CopyBlock(process, process, src_addr, dest_addr, size);
 }
 
 void MemorySystem::CopyBlock(const Kernel::Process& src_process,
                              const Kernel::Process& dest_process, VAddr src_addr, VAddr dest_addr,
                              std::size_t size) {
     auto& page_table{src_process.vm_manager.page_table};
-    std::size_t remaining_size{size};
-    std::size_t page_index{src_addr >> PAGE_BITS};
-    std::size_t page_offset{src_addr & PAGE_MASK};
-    while (remaining_size > 0) {
-        const std::size_t copy_amount{std::min(PAGE_SIZE - page_offset, remaining_size)};
-        const VAddr current_vaddr{static_cast<VAddr>((page_index << PAGE_BITS) + page_offset)};
-        switch (page_table.attributes[page_index]) {
-        case PageType::Unmapped: {
-            LOG_ERROR(HW_Memory,
-                      "unmapped CopyBlock @ 0x{:08X} (start address = 0x{:08X}, size = {})",
-                      current_vaddr, src_addr, size);
-            ZeroBlock(dest_process, dest_addr, copy_amount);
-            break;
-        }
-        case PageType::Memory: {
-            DEBUG_ASSERT(page_table.pointers[page_index]);
-            const u8* src_ptr{page_table.pointers[page_index] + page_offset};
-            WriteBlock(dest_process, dest_addr, src_ptr, copy_amount);
-            break;
-        }
-        case PageType::Special: {
-            MMIORegionPointer handler{GetMMIOHandler(page_table, current_vaddr)};
-            DEBUG_ASSERT(handler);
-            std::vector<u8> buffer(copy_amount);
-            handler->ReadBlock(current_vaddr, buffer.data(), buffer.size());
-            WriteBlock(dest_process, dest_addr, buffer.data(), buffer.size());
-            break;
-        }
-        case PageType::RasterizerCachedMemory: {
-            RasterizerFlushVirtualRegion(current_vaddr, static_cast<u32>(copy_amount),
-                                         FlushMode::Flush);
-            WriteBlock(dest_process, dest_addr, GetPointerForRasterizerCache(current_vaddr),
-                       copy_amount);
-            break;
-        }
-        default:
-            UNREACHABLE();
-        }
-        page_index++;
-        page_offset = 0;
-        dest_addr += static_cast<VAddr>(copy_amount);
-        src_addr += static_cast<VAddr>(copy_amount);
-        remaining_size -= copy_amount;
-    }
+    WalkBlock(page_table, src_addr, size,
+              [&](PageType type, VAddr current_vaddr, const u8* src_ptr, std::size_t copy_amount) {
+                  switch (type) {
+                  case PageType::Unmapped:
+                      LOG_ERROR(
+                          HW_Memory,
+                          "unmapped CopyBlock @ 0x{:08X} (start address = 0x{:08X}, size = {})",
+                          current_vaddr, src_addr, size);
+                      ZeroBlock(dest_process, dest_addr, copy_amount);
+                      break;
+                  case PageType::Memory:
+                      WriteBlock(dest_process, dest_addr, src_ptr, copy_amount);
+                      break;
+                  case PageType::Special: {
+                      MMIORegionPointer handler{GetMMIOHandler(page_table, current_vaddr)};
+                      DEBUG_ASSERT(handler);
+                      std::vector<u8> buffer(copy_amount);
+                      handler->ReadBlock(current_vaddr, buffer.data(), buffer.size());
+                      WriteBlock(dest_process, dest_addr, buffer.data(), buffer.size());
+                      break;
+                  }
+                  case PageType::RasterizerCachedMemory:
+                      RasterizerFlushVirtualRegion(current_vaddr, static_cast<u32>(copy_amount),
+                                                   FlushMode::Flush);
+                      WriteBlock(dest_process, dest_addr, src_ptr, copy_amount);
+                      break;
+                  default:
+                      UNREACHABLE();
+                  }
+                  dest_addr += static_cast<VAddr>(copy_amount);
+              });
 }
 
 template <>
@@ -723,13 +763,13 @@ void WriteMMIO<u64>(MMIORegionPointer mmio_handler, VAddr addr, const u64 data)
 }
 
 u32 MemorySystem::GetFCRAMOffset(u8* pointer) {
-    ASSERT(pointer >= impl->fcram.get() && pointer < impl->fcram.get() + FCRAM_N3DS_SIZE);
-    return pointer - impl->fcram.get();
+    ASSERT(pointer >= impl->fcram && pointer < impl->fcram + FCRAM_N3DS_SIZE);
+    return pointer - impl->fcram;
 }
 
 u8* MemorySystem::GetFCRAMPointer(u32 offset) {
     ASSERT(offset <= FCRAM_N3DS_SIZE);
-    return impl->fcram.get() + offset;
+    return impl->fcram + offset;
 }
 
 } // namespace Memory
@@ -235,6 +235,9 @@ public:
 
     bool IsValidPhysicalAddress(PAddr paddr);
 
+    /// Returns true if the physical range lies entirely within a single memory region
+    bool IsValidPhysicalRange(PAddr address, u64 size);
+
     u8 Read8(VAddr addr);
     u16 Read16(VAddr addr);
     u32 Read32(VAddr addr);
@@ -262,9 +265,20 @@ public:
     /// Gets a pointer to the memory region beginning at the specified physical address.
     u8* GetPhysicalPointer(PAddr address);
 
-    /// Mark each page touching the region as cached.
+    /**
+     * Adds (cached) or removes a rasterizer cache reference to each page touching the region.
+     * Pages are switched to RasterizerCachedMemory when they gain their first reference, and
+     * back to Memory when they lose their last one.
+     */
     void RasterizerMarkRegionCached(PAddr start, u32 size, bool cached);
 
+    /**
+     * Invalidates the rasterizer resources touching rasterizer-cached memory the CPU wrote since
+     * the last call. CPU writes to such memory are only recorded, and must be invalidated before
+     * the rasterizer uses or flushes any of its cached resources.
+     */
+    void RasterizerInvalidatePendingWrites();
+
     /// Flushes any externally cached rasterizer resources touching the given region.
     void RasterizerFlushRegion(PAddr start, u32 size);
 
@@ -308,8 +322,26 @@ private:
      */
     u8* GetPointerForRasterizerCache(VAddr addr);
 
+    /// Records a CPU write to rasterizer-cached memory, to be invalidated later in a batch
+    void MarkRasterizerWrite(VAddr vaddr, u32 size);
+
     void MapPages(PageTable& page_table, u32 base, u32 size, u8* memory, PageType type);
 
+    /**
+     * Splits a virtual range into runs that can be accessed at once: pages of the same type whose
+     * host memory is contiguous, or single MMIO pages. The callback receives the page type, the
+     * virtual address, the host pointer (nullptr for unmapped and MMIO runs) and the size of each
+     * run.
+     */
+    template <typename Func>
+    void WalkBlock(const PageTable& page_table, VAddr start, std::size_t size, Func&& func);
+
+    /// Switches the page type of every virtual alias of a physically contiguous run of pages
+    void MarkPhysicalRunCached(PAddr start, u32 num_pages, bool cached);
+
+    /// Switches the page type of a run of pages in every page table
+    void MarkVirtualRunCached(VAddr start, u8* host, u32 num_pages, bool cached);
+
     struct Impl;
     std::unique_ptr<Impl> impl;
 };
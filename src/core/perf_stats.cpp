@@ -6,6 +6,11 @@
 #include <chrono>
 #include <mutex>
 #include <thread>
+#include <utility>
+#include <vector>
+#include <fmt/format.h>
+#include "common/file_util.h"
+#include "common/logging/log.h"
 #include "core/hw/gpu.h"
 #include "core/perf_stats.h"
 #include "core/settings.h"
@@ -34,6 +39,12 @@ void PerfStats::EndSystemFrame() {
 void PerfStats::EndAppFrame() {
     std::lock_guard lock{object_mutex};
     program_frames += 1;
+    total_program_frames += 1;
+}
+
+u64 PerfStats::GetTotalAppFrames() {
+    std::lock_guard lock{object_mutex};
+    return total_program_frames;
 }
 
 PerfStats::Results PerfStats::GetAndResetStats(microseconds current_system_time_us) {
@@ -63,6 +74,103 @@ double PerfStats::GetLastFrameTimeScale() {
            (1.0 / Settings::values.screen_refresh_rate);
 }
 
+void PerfStats::AddTimingEventSample(const std::string& name, Clock::duration time,
+                                     s64 cycles_late) {
+    std::lock_guard lock{object_mutex};
+    auto& stats{timing_event_stats[name]};
+    stats.dispatch_count += 1;
+    stats.total_time += time;
+    stats.max_time = std::max(stats.max_time, time);
+    stats.total_cycles_late += cycles_late;
+}
+
+std::unordered_map<std::string, PerfStats::TimingEventStats> PerfStats::GetTimingEventStats() {
+    std::lock_guard lock{object_mutex};
+    return timing_event_stats;
+}
+
+void PerfStats::DumpTimingEventStats() {
+    std::vector<std::pair<std::string, TimingEventStats>> sorted;
+    {
+        std::lock_guard lock{object_mutex};
+        sorted.assign(timing_event_stats.begin(), timing_event_stats.end());
+        timing_event_stats.clear();
+    }
+    if (sorted.empty())
+        return;
+    std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+        return a.second.total_time > b.second.total_time;
+    });
+    LOG_INFO(Core_Timing, "Event callback statistics:");
+    for (const auto& [name, stats] : sorted)
+        LOG_INFO(Core_Timing,
+                 "{}: dispatches={} total={}us max={}us average_cycles_late={:.1f}", name,
+                 stats.dispatch_count, duration_cast<microseconds>(stats.total_time).count(),
+                 duration_cast<microseconds>(stats.max_time).count(),
+                 static_cast<double>(stats.total_cycles_late) /
+                     static_cast<double>(stats.dispatch_count));
+}
+
+void PerfStats::SetHLECallProfiling(bool enable) {
+    hle_call_profiling = enable;
+}
+
+static void AddHLECallSample(PerfStats::HLECallStats& stats, const char* name,
+                             PerfStats::Clock::duration time) {
+    stats.name = name;
+    stats.call_count += 1;
+    stats.total_time += time;
+    stats.max_time = std::max(stats.max_time, time);
+}
+
+void PerfStats::AddServiceCallSample(const std::string& service, u32 header, const char* name,
+                                     Clock::duration time) {
+    std::lock_guard lock{object_mutex};
+    AddHLECallSample(service_call_stats[{service, header}], name, time);
+}
+
+void PerfStats::AddSVCCallSample(u32 svc, const char* name, Clock::duration time) {
+    std::lock_guard lock{object_mutex};
+    AddHLECallSample(svc_call_stats[svc], name, time);
+}
+
+std::map<PerfStats::ServiceCallKey, PerfStats::HLECallStats> PerfStats::GetServiceCallStats() {
+    std::lock_guard lock{object_mutex};
+    return service_call_stats;
+}
+
+std::map<u32, PerfStats::HLECallStats> PerfStats::GetSVCCallStats() {
+    std::lock_guard lock{object_mutex};
+    return svc_call_stats;
+}
+
+void PerfStats::DumpHLECallStats(const std::string& path) {
+    std::map<ServiceCallKey, HLECallStats> services;
+    std::map<u32, HLECallStats> svcs;
+    {
+        std::lock_guard lock{object_mutex};
+        services.swap(service_call_stats);
+        svcs.swap(svc_call_stats);
+    }
+    if (services.empty() && svcs.empty())
+        return;
+    std::string csv{"type,target,id,name,calls,total_us,max_us\n"};
+    const auto append_row{[&csv](const char* type, const std::string& target, u32 id,
+                                 const HLECallStats& stats) {
+        csv += fmt::format("{},{},0x{:08X},{},{},{},{}\n", type, target, id, stats.name,
+                           stats.call_count, duration_cast<microseconds>(stats.total_time).count(),
+                           duration_cast<microseconds>(stats.max_time).count());
+    }};
+    for (const auto& [key, stats] : services)
+        append_row("service", key.first, key.second, stats);
+    for (const auto& [svc, stats] : svcs)
+        append_row("svc", "kernel", svc, stats);
+    if (FileUtil::WriteStringToFile(true, csv, path.c_str()) != csv.size())
+        LOG_ERROR(Core, "Failed to write HLE call statistics to {}", path);
+    else
+        LOG_INFO(Core, "HLE call statistics written to {}", path);
+}
+
 void FrameLimiter::DoFrameLimiting(microseconds current_system_time_us) {
     if (frame_advancing_enabled) {
         // Frame advancing is enabled: wait on event instead of doing framelimiting
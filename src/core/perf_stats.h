@@ -6,7 +6,11 @@
 
 #include <atomic>
 #include <chrono>
+#include <map>
 #include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
 #include "common/common_types.h"
 #include "common/thread.h"
 
@@ -34,10 +38,46 @@ public:
         double emulation_speed;
     };
 
+    /// Host cost of the callback of one Core::Timing event type
+    struct TimingEventStats {
+        /// Number of times the callback was dispatched
+        u64 dispatch_count;
+
+        /// Total walltime spent in the callback
+        Clock::duration total_time;
+
+        /// Longest walltime spent in a single dispatch
+        Clock::duration max_time;
+
+        /// Sum of the cycles_late values passed to the callback
+        s64 total_cycles_late;
+    };
+
+    /// Host cost of one HLE service command or SVC
+    struct HLECallStats {
+        /// Name of the command or SVC
+        const char* name;
+
+        /// Number of times it was called
+        u64 call_count;
+
+        /// Total walltime spent handling it
+        Clock::duration total_time;
+
+        /// Longest walltime spent in a single call
+        Clock::duration max_time;
+    };
+
+    /// Service commands are keyed by service name and command header
+    using ServiceCallKey = std::pair<std::string, u32>;
+
     void BeginSystemFrame();
     void EndSystemFrame();
     void EndAppFrame();
 
+    /// Returns the number of program frames (GSP frame submissions) since the object was created
+    u64 GetTotalAppFrames();
+
     Results GetAndResetStats(std::chrono::microseconds current_system_time_us);
 
     /**
@@ -46,6 +86,39 @@ public:
      */
     double GetLastFrameTimeScale();
 
+    /// Records one dispatch of the Core::Timing event type with the given name
+    void AddTimingEventSample(const std::string& name, Clock::duration time, s64 cycles_late);
+
+    /// Returns the statistics of every Core::Timing event type dispatched since the last dump
+    std::unordered_map<std::string, TimingEventStats> GetTimingEventStats();
+
+    /// Logs the statistics of every Core::Timing event type, most expensive first, and clears them
+    void DumpTimingEventStats();
+
+    /// Enables or disables recording HLE service command and SVC statistics
+    void SetHLECallProfiling(bool enable);
+
+    /// Returns whether HLE calls should be recorded. Cheap enough to check on every call.
+    bool IsHLECallProfilingEnabled() const {
+        return hle_call_profiling.load(std::memory_order_relaxed);
+    }
+
+    /// Records one call of the service command with the given header
+    void AddServiceCallSample(const std::string& service, u32 header, const char* name,
+                              Clock::duration time);
+
+    /// Records one call of the SVC with the given number
+    void AddSVCCallSample(u32 svc, const char* name, Clock::duration time);
+
+    /// Returns the statistics of every service command called since the last dump
+    std::map<ServiceCallKey, HLECallStats> GetServiceCallStats();
+
+    /// Returns the statistics of every SVC called since the last dump, keyed by SVC number
+    std::map<u32, HLECallStats> GetSVCCallStats();
+
+    /// Writes the statistics of every service command and SVC to a CSV file and clears them
+    void DumpHLECallStats(const std::string& path);
+
 private:
     std::mutex object_mutex;
 
@@ -64,6 +137,9 @@ private:
     /// Cumulative number of program frames (GSP frame submissions) since last reset
     u32 program_frames{};
 
+    /// Number of program frames (GSP frame submissions) that were never reset
+    u64 total_program_frames{};
+
     /// Point when the previous system frame ended
     Clock::time_point previous_frame_end{reset_point};
 
@@ -72,6 +148,13 @@ private:
 
     /// Total visible duration (including frame-limiting, etc.) of the previous system frame
     Clock::duration previous_frame_length{Clock::duration::zero()};
+
+    /// Callback statistics of the Core::Timing event types, keyed by event name
+    std::unordered_map<std::string, TimingEventStats> timing_event_stats;
+
+    std::atomic_bool hle_call_profiling{};
+    std::map<ServiceCallKey, HLECallStats> service_call_stats;
+    std::map<u32, HLECallStats> svc_call_stats;
 };
 
 class FrameLimiter {
@@ -58,6 +58,8 @@ void LogSettings() {
     LogSetting("ControlPanel_WifiStatus", values.n_wifi_status);
     LogSetting("Core_KeyboardMode", static_cast<int>(values.keyboard_mode));
     LogSetting("Core_EnableNsLaunch", values.enable_ns_launch);
+    LogSetting("Logging_ProfileTimingEvents", values.profile_timing_events);
+    LogSetting("Logging_ProfileHLECalls", values.profile_hle_calls);
     LogSetting("Graphics_EnableShadows", values.enable_shadows);
     LogSetting("Graphics_UseFrameLimit", values.use_frame_limit);
     LogSetting("Graphics_FrameLimit", values.frame_limit);
@@ -67,6 +69,7 @@ void LogSettings() {
     LogSetting("Graphics_UseHwShaders", values.use_hw_shaders);
     LogSetting("Graphics_ShadersAccurateGs", values.shaders_accurate_gs);
     LogSetting("Graphics_ShadersAccurateMul", values.shaders_accurate_mul);
+    LogSetting("Graphics_ShaderJitRemoveDeadCode", values.shader_jit_remove_dead_code);
     LogSetting("Graphics_EnableCacheClear", values.enable_cache_clear);
     LogSetting("Layout_LayoutOption", static_cast<int>(values.layout_option));
     LogSetting("Layout_SwapScreens", values.swap_screens);
@@ -97,6 +100,7 @@ void LogSettings() {
     LogSetting("Hacks_PriorityBoost", values.priority_boost);
     LogSetting("Hacks_Ticks", values.ticks);
     LogSetting("Hacks_TicksMode", static_cast<int>(values.ticks_mode));
+    LogSetting("Hacks_IdleLoopSkippingTitles", values.idle_loop_skipping_titles.size());
     LogSetting("Hacks_IgnoreFormatReinterpretation", values.ignore_format_reinterpretation);
     LogSetting("Hacks_DisableMh2xMsaa", values.disable_mh_2xmsaa);
 }
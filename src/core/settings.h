@@ -7,6 +7,7 @@
 #include <array>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include "common/common_types.h"
 #include "core/hle/service/cam/cam.h"
@@ -19,7 +20,7 @@ namespace Settings {
 
 enum class KeyboardMode { StdIn, Qt };
 
-enum class TicksMode { Auto, Accurate, Custom };
+enum class TicksMode { Auto, Accurate, Custom, Adaptive };
 
 enum class InitClock {
     SystemTime = 0,
@@ -158,6 +159,7 @@ struct Values {
     bool use_hw_shaders;
     bool shaders_accurate_gs;
     bool shaders_accurate_mul;
+    bool shader_jit_remove_dead_code;
     u16 resolution_factor;
     bool use_frame_limit;
     u16 frame_limit;
@@ -184,6 +186,8 @@ struct Values {
 
     // Logging
     std::string log_filter;
+    bool profile_timing_events;
+    bool profile_hle_calls;
 
     // Audio
     bool enable_audio_stretching;
@@ -198,6 +202,7 @@ struct Values {
     bool priority_boost;
     TicksMode ticks_mode;
     u64 ticks;
+    std::unordered_set<u64> idle_loop_skipping_titles;
     bool ignore_format_reinterpretation;
     bool disable_mh_2xmsaa;
     bool force_memory_mode_7;
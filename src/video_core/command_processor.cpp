@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
 #include <future>
@@ -244,10 +245,7 @@ static void WritePicaReg(u32 id, u32 value, u32 mask) {
         if (accelerate_draw &&
             VideoCore::g_renderer->GetRasterizer()->AccelerateDrawBatch(is_indexed))
             break;
-        // Processes information about internal vertex attributes to figure out how a vertex is
-        // loaded. Later, these can be compiled and cached.
         const u32 base_address{regs.pipeline.vertex_attributes.GetPhysicalBaseAddress()};
-        VertexLoader loader{regs.pipeline};
         Shader::OutputVertex::ValidateSemantics(regs.rasterizer);
         // Multithreaded vertex cache. Each thread will lock the vertex that it's processing and add
         // the data to that batch
@@ -284,6 +282,16 @@ static void WritePicaReg(u32 id, u32 value, u32 mask) {
             return is_indexed ? (index_u16 ? index_address_16[index] : index_address_8[index])
                               : (index + regs.pipeline.vertex_offset);
         }};
+        // The largest vertex index of the draw, used to check the attribute arrays up front
+        u32 max_vertex{};
+        if (is_indexed) {
+            for (unsigned int index{}; index < regs.pipeline.num_vertices; ++index)
+                max_vertex = std::max<u32>(max_vertex, VertexIndex(index));
+        } else if (regs.pipeline.num_vertices != 0)
+            max_vertex = regs.pipeline.vertex_offset + regs.pipeline.num_vertices - 1;
+        // Processes information about internal vertex attributes to figure out how a vertex is
+        // loaded, and gets the compiled loader for them.
+        VertexLoader loader{regs.pipeline, max_vertex};
         auto shader_engine{Shader::GetEngine()};
         Shader::UnitState shader_unit;
         shader_engine->SetupBatch(g_state.vs, regs.vs.main_offset);
@@ -134,6 +134,8 @@ Rasterizer::Rasterizer(Core::System& system)
     if (Settings::values.enable_cache_clear) {
         cache_clear_event = timing.RegisterEvent(
             "Rasterizer Cache Clear Event", [this](u64 userdata, s64 cycles_late) {
+                // Apply the deferred CPU writes first, so the flush doesn't overwrite them
+                memory.RasterizerInvalidatePendingWrites();
                 res_cache.Clear();
                 timing.ScheduleEvent(msToCycles(ClearCacheMs), cache_clear_event);
             });
@@ -441,6 +443,8 @@ void Rasterizer::DrawTriangles() {
 }
 
 bool Rasterizer::Draw(bool accelerate, bool is_indexed) {
+    // Surfaces may be stale if the CPU wrote to their memory since the last GPU operation
+    memory.RasterizerInvalidatePendingWrites();
     const auto& regs{Pica::g_state.regs};
     bool shadow_rendering{regs.framebuffer.output_merger.fragment_operation_mode ==
                           Pica::FramebufferRegs::FragmentOperationMode::Shadow};
@@ -1194,6 +1198,7 @@ void Rasterizer::NotifyPicaRegisterChanged(u32 id) {
 }
 
 void Rasterizer::FlushAll() {
+    memory.RasterizerInvalidatePendingWrites();
     res_cache.FlushAll();
 }
 
@@ -1211,6 +1216,7 @@ void Rasterizer::FlushAndInvalidateRegion(PAddr addr, u32 size) {
 }
 
 bool Rasterizer::AccelerateDisplayTransfer(const GPU::Regs::DisplayTransferConfig& config) {
+    memory.RasterizerInvalidatePendingWrites();
     SurfaceParams src_params;
     src_params.addr = config.GetPhysicalInputAddress();
     src_params.width = config.output_width;
@@ -1247,6 +1253,7 @@ bool Rasterizer::AccelerateDisplayTransfer(const GPU::Regs::DisplayTransferConfi
 }
 
 bool Rasterizer::AccelerateTextureCopy(const GPU::Regs::DisplayTransferConfig& config) {
+    memory.RasterizerInvalidatePendingWrites();
     u32 copy_size{Common::AlignDown(config.texture_copy.size, 16)};
     if (copy_size == 0)
         return false;
@@ -1309,6 +1316,7 @@ bool Rasterizer::AccelerateTextureCopy(const GPU::Regs::DisplayTransferConfig& c
 }
 
 bool Rasterizer::AccelerateFill(const GPU::Regs::MemoryFillConfig& config) {
+    memory.RasterizerInvalidatePendingWrites();
     Surface dst_surface{res_cache.GetFillSurface(config)};
     if (!dst_surface)
         return false;
@@ -1319,6 +1327,7 @@ bool Rasterizer::AccelerateFill(const GPU::Regs::MemoryFillConfig& config) {
 bool Rasterizer::AccelerateDisplay(const GPU::Regs::FramebufferConfig& config,
                                    PAddr framebuffer_addr, u32 pixel_stride,
                                    ScreenInfo& screen_info) {
+    memory.RasterizerInvalidatePendingWrites();
     if (framebuffer_addr == 0)
         return false;
     SurfaceParams src_params;
@@ -1427,39 +1427,13 @@ void RasterizerCache::RegisterSurface(const Surface& surface) {
         return;
     surface->registered = true;
     surface_cache.add({surface->GetInterval(), SurfaceSet{surface}});
-    UpdatePagesCachedCount(surface->addr, surface->size, 1);
+    memory.RasterizerMarkRegionCached(surface->addr, surface->size, true);
 }
 
 void RasterizerCache::UnregisterSurface(const Surface& surface) {
     if (!surface->registered)
         return;
     surface->registered = false;
-    UpdatePagesCachedCount(surface->addr, surface->size, -1);
+    memory.RasterizerMarkRegionCached(surface->addr, surface->size, false);
     surface_cache.subtract({surface->GetInterval(), SurfaceSet{surface}});
 }
-
-void RasterizerCache::UpdatePagesCachedCount(PAddr addr, u32 size, int delta) {
-    const u32 num_pages{((addr + size - 1) >> Memory::PAGE_BITS) - (addr >> Memory::PAGE_BITS) + 1};
-    const u32 page_start{addr >> Memory::PAGE_BITS};
-    const u32 page_end{page_start + num_pages};
-    // Interval maps will erase segments if count reaches 0, so if delta is negative we have to
-    // subtract after iterating
-    const auto pages_interval{PageMap::interval_type::right_open(page_start, page_end)};
-    if (delta > 0)
-        cached_pages.add({pages_interval, delta});
-    for (auto& pair : RangeFromInterval(cached_pages, pages_interval)) {
-        const auto interval{pair.first & pages_interval};
-        const int count{pair.second};
-        const PAddr interval_start_addr{boost::icl::first(interval) << Memory::PAGE_BITS};
-        const PAddr interval_end_addr{boost::icl::last_next(interval) << Memory::PAGE_BITS};
-        const u32 interval_size{interval_end_addr - interval_start_addr};
-        if (delta > 0 && count == delta)
-            memory.RasterizerMarkRegionCached(interval_start_addr, interval_size, true);
-        else if (delta < 0 && count == -delta)
-            memory.RasterizerMarkRegionCached(interval_start_addr, interval_size, false);
-        else
-            ASSERT(count >= 0);
-    }
-    if (delta < 0)
-        cached_pages.add({pages_interval, delta});
-}
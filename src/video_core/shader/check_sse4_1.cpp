@@ -60,6 +60,29 @@ static const bool CheckSSE41Supported() {
     return false;
 }
 
+static const bool CheckAVXSupported() {
+    int cpu_id[4];
+    __cpuid(cpu_id, 0x00000000);
+    int max_std_fn{cpu_id[0]}; // EAX
+    if (max_std_fn < 1)
+        return false;
+    __cpuid(cpu_id, 0x00000001);
+    // The OS must also save the YMM registers on context switches, as reported by XGETBV
+    if (!((cpu_id[2] >> 28) & 1) || !((cpu_id[2] >> 27) & 1))
+        return false;
+    return (_xgetbv(_XCR_XFEATURE_ENABLED_MASK) & 0x6) == 0x6;
+}
+
+static const bool CheckAVX2Supported() {
+    int cpu_id[4];
+    __cpuid(cpu_id, 0x00000000);
+    int max_std_fn{cpu_id[0]}; // EAX
+    if (max_std_fn < 7 || !CheckAVXSupported())
+        return false;
+    __cpuidex(cpu_id, 0x00000007, 0);
+    return (cpu_id[1] >> 5) & 1;
+}
+
 namespace Pica::Shader {
 
 const bool IsSSE41Supported() {
@@ -67,4 +90,14 @@ const bool IsSSE41Supported() {
     return supported;
 }
 
+const bool IsAVXSupported() {
+    static const bool supported{CheckAVXSupported()};
+    return supported;
+}
+
+const bool IsAVX2Supported() {
+    static const bool supported{CheckAVX2Supported()};
+    return supported;
+}
+
 } // namespace Pica::Shader
@@ -6,4 +6,9 @@ namespace Pica::Shader {
 
 const bool IsSSE41Supported();
 
+/// Returns whether the CPU and the OS support VEX-encoded instructions
+const bool IsAVXSupported();
+
+const bool IsAVX2Supported();
+
 } // namespace Pica::Shader
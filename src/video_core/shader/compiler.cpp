@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <bitset>
 #include <cmath>
 #include <cstdint>
 #include <nihstro/shader_bytecode.h>
@@ -13,6 +14,7 @@
 #include "common/vector_math.h"
 #include "common/x64/xbyak_abi.h"
 #include "common/x64/xbyak_util.h"
+#include "core/settings.h"
 #include "video_core/pica_state.h"
 #include "video_core/pica_types.h"
 #include "video_core/shader/check_sse4_1.h"
@@ -123,6 +125,19 @@ constexpr u8 NO_SRC_REG_SWIZZLE{0x1b};
 /// Raw constant for the destination register enable mask that indicates all components are enabled
 constexpr u8 NO_DEST_REG_MASK{0xf};
 
+/// Registers available to keep temporaries in for the whole program
+static const std::array<Xmm, 9> temporary_regs{
+    xmm5, xmm6, xmm7, xmm8, xmm9, xmm10, xmm11, xmm12, xmm13,
+};
+
+/// Minimum number of instructions using a temporary for it to be kept in a register, as it has
+/// to be loaded when the program starts and stored when it ends
+constexpr unsigned MIN_CACHED_TEMPORARY_USES{3};
+
+static std::size_t TemporaryOffset(std::size_t index) {
+    return offsetof(UnitState, registers.temporary) + index * sizeof(Math::Vec4<float24>);
+}
+
 static void LogCritical(const char* msg) {
     LOG_CRITICAL(HW_GPU, "{}", msg);
 }
@@ -169,33 +184,49 @@ void Shader::Compile_SwizzleSrc(Instruction instr, unsigned src_num, SourceRegis
         offset_src = is_inverted ? 2 : 1;
         address_register_index = instr.common.address_register_index;
     }
-    if (src_num == offset_src && address_register_index != 0) {
+    const bool relative{src_num == offset_src && address_register_index != 0};
+    Xbyak::RegExp src_address{src_ptr + src_offset_disp};
+    if (relative) {
         switch (address_register_index) {
         case 1: // address offset 1
-            movaps(dest, xword[src_ptr + r10 + src_offset_disp]);
+            src_address = src_ptr + r10 + src_offset_disp;
             break;
         case 2: // address offset 2
-            movaps(dest, xword[src_ptr + r11 + src_offset_disp]);
+            src_address = src_ptr + r11 + src_offset_disp;
             break;
         case 3: // address offset 3
-            movaps(dest, xword[src_ptr + r12d.cvt64() + src_offset_disp]);
+            src_address = src_ptr + r12d.cvt64() + src_offset_disp;
             break;
         default:
             UNREACHABLE();
             break;
         }
-    } else
-        // Load the source
-        movaps(dest, xword[src_ptr + src_offset_disp]);
+    }
+    // Temporaries kept in XMM registers are read from there, except when an address register is
+    // used, in which case they have been written back to the unit state before the instruction
+    std::optional<Xmm> cached;
+    if (src_reg.GetRegisterType() == RegisterType::Temporary && !relative)
+        cached = cached_temporaries[src_reg.GetIndex()];
+    const Xbyak::Address src_mem{xword[src_address]};
+    const Xbyak::Operand& src{cached ? static_cast<const Xbyak::Operand&>(*cached) : src_mem};
     SwizzlePattern swiz{(*swizzle_data)[operand_desc_id]};
     // Generate instructions for source register swizzling as needed
     u8 sel{static_cast<u8>(swiz.GetRawSelector(src_num))};
     if (sel != NO_SRC_REG_SWIZZLE) {
         // Selector component order needs to be reversed for the SHUFPS instruction
         sel = ((sel & 0xc0) >> 6) | ((sel & 3) << 6) | ((sel & 0xc) << 2) | ((sel & 0x30) >> 2);
-        // Shuffle inputs for swizzle
-        shufps(dest, dest, sel);
-    }
+        if (IsAVXSupported())
+            // Load and shuffle the source with a single instruction
+            vpermilps(dest, src, sel);
+        else {
+            // Load the source
+            movaps(dest, src);
+            // Shuffle inputs for swizzle
+            shufps(dest, dest, sel);
+        }
+    } else
+        // Load the source
+        movaps(dest, src);
     // If the source register should be negated, flip the negative bit using XOR
     const bool negate[]{swiz.negate_src1, swiz.negate_src2, swiz.negate_src3};
     if (negate[src_num - 1])
@@ -215,19 +246,40 @@ void Shader::Compile_DestEnable(Instruction instr, Xmm src) {
     }
     SwizzlePattern swiz{(*swizzle_data)[operand_desc_id]};
     std::size_t dest_offset_disp{UnitState::OutputOffset(dest)};
+    std::optional<Xmm> cached;
+    if (dest.GetRegisterType() == RegisterType::Temporary)
+        cached = cached_temporaries[dest.GetIndex()];
+    const Xbyak::Address dest_mem{xword[r15 + dest_offset_disp]};
+    const Xbyak::Operand& dest_op{cached ? static_cast<const Xbyak::Operand&>(*cached)
+                                         : dest_mem};
     // If all components are enabled, write the result to the destination register
-    if (swiz.dest_mask == NO_DEST_REG_MASK)
-        // Store dest back to memory
-        movaps(xword[r15 + dest_offset_disp], src);
-    else {
+    if (swiz.dest_mask == NO_DEST_REG_MASK) {
+        if (cached)
+            movaps(*cached, src);
+        else
+            // Store dest back to memory
+            movaps(dest_mem, src);
+    } else {
         // Not all components are enabled, so mask the result when storing to the destination
         // register...
-        movaps(xmm0, xword[r15 + dest_offset_disp]);
-        if (IsSSE41Supported()) {
-            u8 mask{static_cast<u8>(((swiz.dest_mask & 1) << 3) | ((swiz.dest_mask & 8) >> 3) |
-                                    ((swiz.dest_mask & 2) << 1) | ((swiz.dest_mask & 4) >> 1))};
+        u8 mask{static_cast<u8>(((swiz.dest_mask & 1) << 3) | ((swiz.dest_mask & 8) >> 3) |
+                                ((swiz.dest_mask & 2) << 1) | ((swiz.dest_mask & 4) >> 1))};
+        if (cached && IsAVXSupported()) {
+            vblendps(*cached, *cached, src, mask);
+            return;
+        }
+        if (cached && IsSSE41Supported()) {
+            blendps(*cached, src, mask);
+            return;
+        }
+        if (IsAVXSupported())
+            // Take the disabled components from memory, without loading the destination first
+            vblendps(xmm0, src, dest_mem, mask ^ 0xf);
+        else if (IsSSE41Supported()) {
+            movaps(xmm0, dest_mem);
             blendps(xmm0, src, mask);
         } else {
+            movaps(xmm0, dest_op);
             movaps(xmm4, src);
             unpckhps(xmm4, xmm0); // Unpack X/Y components of source and destination
             unpcklps(xmm0, src);  // Unpack Z/W components of source and destination
@@ -239,8 +291,11 @@ void Shader::Compile_DestEnable(Instruction instr, Xmm src) {
                                    ((swiz.DestComponentEnabled(3) ? 2 : 3) << 6))};
             shufps(xmm0, xmm4, sel);
         }
-        // Store dest back to memory
-        movaps(xword[r15 + dest_offset_disp], xmm0);
+        if (cached)
+            movaps(*cached, xmm0);
+        else
+            // Store dest back to memory
+            movaps(dest_mem, xmm0);
     }
 }
 
@@ -249,13 +304,20 @@ void Shader::Compile_SanitizedMul(Xmm src1, Xmm src2, Xmm scratch) {
     // checking for NaNs before and after the multiplication.  If the multiplication result is NaN
     // where neither source was, this NaN was generated by a 0 * inf multiplication, and so the
     // result should be transformed to 0 to match PICA fp rules.
-    // Set scratch to mask of (src1 != NaN and src2 != NaN)
-    movaps(scratch, src1);
-    cmpordps(scratch, src2);
-    mulps(src1, src2);
-    // Set src2 to mask of (result == NaN)
-    movaps(src2, src1);
-    cmpunordps(src2, src2);
+    if (IsAVXSupported()) {
+        // Same as below, the three operand forms avoid the copies
+        vcmpordps(scratch, src1, src2);
+        vmulps(src1, src1, src2);
+        vcmpunordps(src2, src1, src1);
+    } else {
+        // Set scratch to mask of (src1 != NaN and src2 != NaN)
+        movaps(scratch, src1);
+        cmpordps(scratch, src2);
+        mulps(src1, src2);
+        // Set src2 to mask of (result == NaN)
+        movaps(src2, src1);
+        cmpunordps(src2, src2);
+    }
     // Clear components where scratch != src2 (i.e. if result is NaN where neither source was NaN)
     xorps(scratch, src2);
     andps(src1, scratch);
@@ -295,7 +357,7 @@ void Shader::Compile_UniformCondition(Instruction instr) {
 }
 
 BitSet32 Shader::PersistentCallerSavedRegs() {
-    return persistent_regs & ABI_ALL_CALLER_SAVED;
+    return (persistent_regs | cached_regs) & ABI_ALL_CALLER_SAVED;
 }
 
 void Shader::Compile_ADD(Instruction instr) {
@@ -309,10 +371,15 @@ void Shader::Compile_DP3(Instruction instr) {
     Compile_SwizzleSrc(instr, 1, instr.common.src1, xmm1);
     Compile_SwizzleSrc(instr, 2, instr.common.src2, xmm2);
     Compile_SanitizedMul(xmm1, xmm2, xmm0);
-    movaps(xmm2, xmm1);
-    shufps(xmm2, xmm2, _MM_SHUFFLE(1, 1, 1, 1));
-    movaps(xmm3, xmm1);
-    shufps(xmm3, xmm3, _MM_SHUFFLE(2, 2, 2, 2));
+    if (IsAVXSupported()) {
+        vshufps(xmm2, xmm1, xmm1, _MM_SHUFFLE(1, 1, 1, 1));
+        vshufps(xmm3, xmm1, xmm1, _MM_SHUFFLE(2, 2, 2, 2));
+    } else {
+        movaps(xmm2, xmm1);
+        shufps(xmm2, xmm2, _MM_SHUFFLE(1, 1, 1, 1));
+        movaps(xmm3, xmm1);
+        shufps(xmm3, xmm3, _MM_SHUFFLE(2, 2, 2, 2));
+    }
     shufps(xmm1, xmm1, _MM_SHUFFLE(0, 0, 0, 0));
     addps(xmm1, xmm2);
     addps(xmm1, xmm3);
@@ -494,6 +561,7 @@ void Shader::Compile_END(Instruction instr) {
     mov(dword[r15 + offsetof(UnitState, address_registers[0])], r10.cvt32());
     mov(dword[r15 + offsetof(UnitState, address_registers[1])], r11.cvt32());
     mov(dword[r15 + offsetof(UnitState, address_registers[2])], r12d);
+    Compile_StoreCachedTemporaries();
     ABI_PopRegistersAndAdjustStack(*this, ABI_ALL_CALLEE_SAVED, 8, 16);
     ret();
 }
@@ -712,7 +780,13 @@ void Shader::Compile_NextInstr() {
     if (std::binary_search(return_offsets.begin(), return_offsets.end(), program_counter))
         Compile_Return();
     L(instruction_labels[program_counter]);
+    const unsigned offset{program_counter};
     Instruction instr{(*program_code)[program_counter++]};
+    if (dead_instructions[offset])
+        // Nothing reads the result, so the instruction doesn't need to be compiled
+        return;
+    if (relative_reads[offset])
+        Compile_StoreCachedTemporaries();
     OpCode::Id opcode{instr.opcode.Value()};
     auto instr_func{instr_table[static_cast<unsigned>(opcode)]};
     if (instr_func)
@@ -743,6 +817,183 @@ void Shader::FindReturnOffsets() {
     std::sort(return_offsets.begin(), return_offsets.end());
 }
 
+void Shader::AnalyzeRegisters() {
+    constexpr std::size_t size{MAX_PROGRAM_CODE_LENGTH};
+    // Components of the temporaries read and written by each instruction, with bit 4 * i + j
+    // corresponding to the component j of the temporary i
+    std::vector<u64> reads(size), writes(size);
+    // Instructions that write temporaries and nothing else, which can be removed
+    std::bitset<size> removable;
+    // Instructions that can continue at the next instruction
+    std::bitset<size> falls_through;
+    // Other instructions that can run after each instruction
+    std::vector<std::vector<unsigned>> jumps(size);
+    auto add_jump{[&jumps](unsigned from, unsigned to) {
+        if (from < size && to < size)
+            jumps[from].push_back(to);
+    }};
+    // Continuations of the CALLs returning at each offset. The return check is emitted at the
+    // return offset itself, so any edge reaching it can also continue after one of those CALLs.
+    std::vector<std::vector<unsigned>> returns(size);
+    std::vector<std::pair<unsigned, unsigned>> loops;
+    std::vector<unsigned> breaks;
+    relative_reads.reset();
+    for (unsigned offset{}; offset < size; ++offset) {
+        Instruction instr{(*program_code)[offset]};
+        OpCode::Info info{instr.opcode.Value().GetInfo()};
+        falls_through.set(offset);
+        OpCode::Id opcode{instr.opcode.Value()};
+        // Unhandled instructions aren't compiled, so they don't access any register
+        if (!instr_table[static_cast<unsigned>(opcode)])
+            continue;
+        auto read{[&](const SwizzlePattern& swiz, unsigned src_num, SourceRegister reg,
+                      bool relative) {
+            if (reg.GetRegisterType() == RegisterType::FloatUniform)
+                return;
+            if (relative) {
+                // The address registers can make the read reach any temporary
+                reads[offset] = ~u64{};
+                relative_reads.set(offset);
+                return;
+            }
+            if (reg.GetRegisterType() != RegisterType::Temporary)
+                return;
+            u32 sel{swiz.GetRawSelector(src_num)};
+            for (unsigned i{}; i < 4; ++i)
+                reads[offset] |= u64{1} << (reg.GetIndex() * 4 + ((sel >> (6 - 2 * i)) & 3));
+        }};
+        auto write{[&](const SwizzlePattern& swiz, DestRegister reg) {
+            if (reg.GetRegisterType() != RegisterType::Temporary)
+                return;
+            for (unsigned i{}; i < 4; ++i)
+                if (swiz.DestComponentEnabled(i))
+                    writes[offset] |= u64{1} << (reg.GetIndex() * 4 + i);
+            removable.set(offset);
+        }};
+        if (info.type == OpCode::Type::Arithmetic) {
+            SwizzlePattern swiz{(*swizzle_data)[instr.common.operand_desc_id]};
+            const bool is_inverted{(info.subtype & OpCode::Info::SrcInversed) != 0};
+            const bool relative{instr.common.address_register_index != 0};
+            read(swiz, 1, instr.common.GetSrc1(is_inverted), relative && !is_inverted);
+            if (info.subtype & OpCode::Info::Src2)
+                read(swiz, 2, instr.common.GetSrc2(is_inverted), relative && is_inverted);
+            // CMP and MOVA don't have a destination register
+            if (info.subtype & OpCode::Info::Dest)
+                write(swiz, instr.common.dest.Value());
+            continue;
+        }
+        if (info.type == OpCode::Type::MultiplyAdd) {
+            SwizzlePattern swiz{(*swizzle_data)[instr.mad.operand_desc_id]};
+            const bool is_inverted{instr.opcode.Value().EffectiveOpCode() == OpCode::Id::MADI};
+            const bool relative{instr.mad.address_register_index != 0};
+            read(swiz, 1, instr.mad.GetSrc1(is_inverted), false);
+            read(swiz, 2, instr.mad.GetSrc2(is_inverted), relative && !is_inverted);
+            read(swiz, 3, instr.mad.GetSrc3(is_inverted), relative && is_inverted);
+            write(swiz, instr.mad.dest.Value());
+            continue;
+        }
+        const unsigned dest{instr.flow_control.dest_offset};
+        const unsigned num{instr.flow_control.num_instructions};
+        switch (instr.opcode.Value()) {
+        case OpCode::Id::END:
+            falls_through.reset(offset);
+            break;
+        case OpCode::Id::JMPC:
+        case OpCode::Id::JMPU:
+            add_jump(offset, dest);
+            break;
+        case OpCode::Id::CALL:
+        case OpCode::Id::CALLC:
+        case OpCode::Id::CALLU:
+            add_jump(offset, dest);
+            if (dest + num > 0)
+                add_jump(dest + num - 1, offset + 1);
+            if (dest + num < size && offset + 1 < size)
+                returns[dest + num].push_back(offset + 1);
+            break;
+        case OpCode::Id::IFU:
+        case OpCode::Id::IFC:
+            // The code for the condition evaluating as true skips over the "ELSE" block
+            add_jump(offset, dest);
+            if (dest > 0)
+                add_jump(dest - 1, dest + num);
+            break;
+        case OpCode::Id::LOOP:
+            add_jump(dest, offset + 1);
+            loops.emplace_back(offset, dest);
+            break;
+        case OpCode::Id::BREAKC:
+            breaks.push_back(offset);
+            break;
+        default:
+            break;
+        }
+    }
+    for (unsigned offset : breaks)
+        for (const auto& [start, end] : loops)
+            if (start < offset && offset <= end)
+                add_jump(offset, end + 1);
+
+    // Iterate backwards until the liveness of the components stops changing. Temporaries aren't
+    // preserved between invocations, so nothing is live after END. The results of instructions
+    // removed as dead aren't read either, which allows removing chains of dead instructions.
+    dead_instructions.reset();
+    std::vector<u64> live_in(size);
+    bool changed{Settings::values.shader_jit_remove_dead_code};
+    while (changed) {
+        changed = false;
+        for (unsigned offset{size}; offset-- > 0;) {
+            u64 live_out{};
+            auto add_successor{[&](unsigned target) {
+                live_out |= live_in[target];
+                for (unsigned continuation : returns[target])
+                    live_out |= live_in[continuation];
+            }};
+            if (falls_through[offset] && offset + 1 < size)
+                add_successor(offset + 1);
+            for (unsigned target : jumps[offset])
+                add_successor(target);
+            const bool dead{removable[offset] && (writes[offset] & live_out) == 0};
+            dead_instructions[offset] = dead;
+            const u64 live{dead ? live_out : reads[offset] | (live_out & ~writes[offset])};
+            if (live != live_in[offset]) {
+                live_in[offset] = live;
+                changed = true;
+            }
+        }
+    }
+
+    // Keep the temporaries used by the most instructions in registers
+    std::array<unsigned, 16> uses{};
+    for (unsigned offset{}; offset < size; ++offset) {
+        if (dead_instructions[offset] || relative_reads[offset])
+            continue;
+        const u64 used{reads[offset] | writes[offset]};
+        for (unsigned i{}; i < uses.size(); ++i)
+            if ((used >> (i * 4)) & 0xf)
+                ++uses[i];
+    }
+    std::array<unsigned, 16> order;
+    for (unsigned i{}; i < order.size(); ++i)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(),
+                     [&uses](unsigned a, unsigned b) { return uses[a] > uses[b]; });
+    cached_temporaries.fill(std::nullopt);
+    cached_regs = {};
+    for (std::size_t i{}; i < temporary_regs.size(); ++i) {
+        if (uses[order[i]] < MIN_CACHED_TEMPORARY_USES)
+            break;
+        cached_temporaries[order[i]] = temporary_regs[i];
+        cached_regs[RegToIndex(temporary_regs[i])] = true;
+    }
+}
+
+void Shader::Compile_StoreCachedTemporaries() {
+    for (std::size_t i{}; i < cached_temporaries.size(); ++i)
+        if (cached_temporaries[i])
+            movaps(xword[r15 + TemporaryOffset(i)], *cached_temporaries[i]);
+}
+
 void Shader::Compile(const std::array<u32, MAX_PROGRAM_CODE_LENGTH>* program_code_,
                      const std::array<u32, MAX_SWIZZLE_DATA_LENGTH>* swizzle_data_) {
     program_code = program_code_;
@@ -754,6 +1005,8 @@ void Shader::Compile(const std::array<u32, MAX_PROGRAM_CODE_LENGTH>* program_cod
     instruction_labels.fill(Xbyak::Label());
     // Find all `CALL` instructions and identify return locations
     FindReturnOffsets();
+    // Find dead instructions and the temporaries to keep in registers
+    AnalyzeRegisters();
     // The stack pointer is 8 modulo 16 at the entry of a procedure
     // We reserve 16 bytes and assign a dummy value to the first 8 bytes, to catch any potential
     // return checks (see Compile_Return) that happen in shader main routine.
@@ -779,6 +1032,10 @@ void Shader::Compile(const std::array<u32, MAX_PROGRAM_CODE_LENGTH>* program_cod
     static const __m128 neg{-0.f, -0.f, -0.f, -0.f};
     mov(rax, reinterpret_cast<std::size_t>(&neg));
     movaps(xmm15, xword[rax]);
+    // Load the temporaries kept in registers
+    for (std::size_t i{}; i < cached_temporaries.size(); ++i)
+        if (cached_temporaries[i])
+            movaps(*cached_temporaries[i], xword[r15 + TemporaryOffset(i)]);
     // Jump to start of the shader program
     jmp(ABI_PARAM3);
     // Compile entire program
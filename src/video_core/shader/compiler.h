@@ -5,6 +5,7 @@
 #pragma once
 
 #include <array>
+#include <bitset>
 #include <cstddef>
 #include <optional>
 #include <utility>
@@ -93,6 +94,17 @@ private:
     void FindReturnOffsets(); ///< Analyzes the entire shader program for `CALL` instructions before
                               /// emitting any code, identifying the locations where a return needs
                               /// to be inserted.
+
+    /**
+     * Computes the liveness of the components of the temporary registers before emitting any
+     * code, to find the instructions whose results are never read and the temporaries that are
+     * used often enough to be kept in XMM registers.
+     */
+    void AnalyzeRegisters();
+
+    /// Writes the temporaries kept in XMM registers back to the unit state
+    void Compile_StoreCachedTemporaries();
+
     /// Emits data and code for utility functions.
     void CompilePrelude();
     Xbyak::Label CompilePrelude_Log2();
@@ -107,6 +119,14 @@ private:
     std::vector<unsigned> return_offsets; ///< Offsets in code where a return needs to be inserted
     unsigned program_counter{};           ///< Offset of the next instruction to decode
     bool looping{}; ///< True if compiling a loop, used to check for nested loops
+    /// Instructions that only write temporary components which are never read afterwards
+    std::bitset<MAX_PROGRAM_CODE_LENGTH> dead_instructions;
+    /// Instructions using an address register to read an input or temporary register. The
+    /// temporaries kept in XMM registers are written back before these instructions.
+    std::bitset<MAX_PROGRAM_CODE_LENGTH> relative_reads;
+    /// XMM register holding each temporary for the whole program, if any
+    std::array<std::optional<Xbyak::Xmm>, 16> cached_temporaries;
+    BitSet32 cached_regs; ///< Set of the XMM registers holding temporaries
     using CompiledShader = void(const void* setup, void* state, const u8* start_addr);
     CompiledShader* program{};
     Xbyak::Label log2_subroutine;
@@ -4,13 +4,42 @@
 
 #include "video_core/shader/compiler.h"
 #include "video_core/shader/engine.h"
+#include "video_core/shader/interpreter.h"
 #include "video_core/shader/shader.h"
 
 namespace Pica::Shader {
 
-ShaderEngine::ShaderEngine() = default;
+ShaderEngine::ShaderEngine() : compile_thread{[this] { CompileLoop(); }} {}
 
-ShaderEngine::~ShaderEngine() = default;
+ShaderEngine::~ShaderEngine() {
+    {
+        std::lock_guard lock{queue_mutex};
+        stop_compiling = true;
+    }
+    queue_cv.notify_one();
+    compile_thread.join();
+}
+
+void ShaderEngine::QueueCompilation(std::function<void()> work) {
+    {
+        std::lock_guard lock{queue_mutex};
+        queue.push_back(std::move(work));
+    }
+    queue_cv.notify_one();
+}
+
+void ShaderEngine::CompileLoop() {
+    for (;;) {
+        std::unique_lock lock{queue_mutex};
+        queue_cv.wait(lock, [this] { return stop_compiling || !queue.empty(); });
+        if (stop_compiling)
+            return;
+        auto work{std::move(queue.front())};
+        queue.pop_front();
+        lock.unlock();
+        work();
+    }
+}
 
 void ShaderEngine::SetupBatch(ShaderSetup& setup, unsigned int entry_point) {
     ASSERT(entry_point < MAX_PROGRAM_CODE_LENGTH);
@@ -19,20 +48,27 @@ void ShaderEngine::SetupBatch(ShaderSetup& setup, unsigned int entry_point) {
     u64 swizzle_hash{setup.GetSwizzleDataHash()};
     u64 cache_key{code_hash ^ swizzle_hash};
     auto iter{cache.find(cache_key)};
-    if (iter != cache.end())
-        setup.engine_data.cached_shader = iter->second.get();
-    else {
-        auto shader{std::make_unique<Shader>()};
-        shader->Compile(&setup.program_code, &setup.swizzle_data);
-        setup.engine_data.cached_shader = shader.get();
-        cache.emplace_hint(iter, cache_key, std::move(shader));
+    if (iter == cache.end()) {
+        iter = cache.emplace_hint(iter, cache_key, std::make_unique<CacheEntry>());
+        // The setup can change before the compilation is done, so the program is copied
+        QueueCompilation([entry = iter->second.get(), program_code = setup.program_code,
+                          swizzle_data = setup.swizzle_data] {
+            entry->shader = std::make_unique<Shader>();
+            entry->shader->Compile(&program_code, &swizzle_data);
+            entry->ready.store(true, std::memory_order_release);
+        });
     }
+    const CacheEntry& entry{*iter->second};
+    setup.engine_data.cached_shader =
+        entry.ready.load(std::memory_order_acquire) ? entry.shader.get() : nullptr;
 }
 
 void ShaderEngine::Run(const ShaderSetup& setup, UnitState& state) const {
-    ASSERT(setup.engine_data.cached_shader);
     const Shader* shader{static_cast<const Shader*>(setup.engine_data.cached_shader)};
-    shader->Run(setup, state, setup.engine_data.entry_point);
+    if (shader)
+        shader->Run(setup, state, setup.engine_data.entry_point);
+    else
+        RunInterpreter(setup, state, setup.engine_data.entry_point);
 }
 
 } // namespace Pica::Shader
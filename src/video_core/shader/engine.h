@@ -4,7 +4,13 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
 #include "common/common_types.h"
 
@@ -21,12 +27,14 @@ public:
 
     /**
      * Performs any shader unit setup that only needs to happen once per shader (as opposed to once
-     * per vertex, which would happen within the Run function).
+     * per vertex, which would happen within the Run function). New programs are compiled on the
+     * compile thread, and are interpreted until the compiled shader is ready.
      */
     void SetupBatch(ShaderSetup& setup, unsigned int entry_point);
 
     /**
-     * Runs the currently setup shader.
+     * Runs the currently setup shader, with the JIT if it's compiled or with the interpreter
+     * otherwise.
      *
      * @param setup Shader engine state, must be setup with SetupBatch on each shader change.
      * @param state Shader unit state, must be setup with input data before each shader invocation.
@@ -34,7 +42,25 @@ public:
     void Run(const ShaderSetup& setup, UnitState& state) const;
 
 private:
-    std::unordered_map<u64, std::unique_ptr<Shader>> cache;
+    struct CacheEntry {
+        /// Written by the compile thread before setting ready
+        std::unique_ptr<Shader> shader;
+        std::atomic_bool ready{};
+    };
+
+    /// Queues work for the compile thread
+    void QueueCompilation(std::function<void()> work);
+
+    void CompileLoop();
+
+    // Entries are only added and looked up on the GPU thread
+    std::unordered_map<u64, std::unique_ptr<CacheEntry>> cache;
+
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;
+    std::deque<std::function<void()>> queue;
+    bool stop_compiling{};
+    std::thread compile_thread;
 };
 
 } // namespace Pica::Shader
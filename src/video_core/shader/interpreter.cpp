@@ -0,0 +1,429 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <nihstro/shader_bytecode.h>
+#include "common/assert.h"
+#include "common/logging/log.h"
+#include "common/vector_math.h"
+#include "video_core/pica_types.h"
+#include "video_core/shader/interpreter.h"
+#include "video_core/shader/shader.h"
+
+using nihstro::Instruction;
+using nihstro::OpCode;
+using nihstro::SwizzlePattern;
+
+namespace Pica::Shader {
+
+namespace {
+
+/// Scope entered by IF, CALL and LOOP, left when reaching final_address
+struct CallStackElement {
+    u32 final_address;  ///< Address upon which the scope is left
+    u32 return_address; ///< Address to continue at after leaving the scope
+    u32 repeat_counter; ///< Remaining iterations of a loop
+    u32 loop_increment; ///< Value added to the loop counter after each iteration
+    u32 loop_address;   ///< First instruction of the loop body
+    bool is_loop;
+};
+
+/// The hardware supports 8 levels of IF, 4 of CALL and 4 of LOOP
+constexpr std::size_t MAX_CALL_STACK_DEPTH{16};
+
+using Register = Math::Vec4<float24>;
+
+Register LookupSourceRegister(const ShaderSetup& setup, const UnitState& state,
+                              const SourceRegister& reg, s32 address_offset) {
+    const s32 index{reg.GetIndex() + address_offset};
+    switch (reg.GetRegisterType()) {
+    case RegisterType::FloatUniform:
+        if (index >= 0 && index < 96)
+            return setup.uniforms.f[index];
+        break;
+    case RegisterType::Input:
+    case RegisterType::Temporary: {
+        // Like in the JIT, relative addressing can go past the input registers into the temporary
+        // and output ones, as they're contiguous in UnitState
+        const s32 register_index{index +
+                                 (reg.GetRegisterType() == RegisterType::Temporary ? 16 : 0)};
+        if (register_index >= 0 && register_index < 16)
+            return state.registers.input[register_index];
+        if (register_index >= 16 && register_index < 32)
+            return state.registers.temporary[register_index - 16];
+        if (register_index >= 32 && register_index < 48)
+            return state.registers.output[register_index - 32];
+        break;
+    }
+    default:
+        break;
+    }
+    // The JIT reads outside of the register file in this case, which is undefined
+    return Math::MakeVec(float24::Zero(), float24::Zero(), float24::Zero(), float24::Zero());
+}
+
+Register SwizzleSource(const Register& value, SwizzlePattern swiz, unsigned src_num) {
+    const bool negate[]{swiz.negate_src1, swiz.negate_src2, swiz.negate_src3};
+    const u32 selector{swiz.GetRawSelector(src_num)};
+    Register result;
+    for (unsigned component{}; component < 4; ++component) {
+        result[component] = value[(selector >> (6 - 2 * component)) & 3];
+        if (negate[src_num - 1])
+            result[component] = -result[component];
+    }
+    return result;
+}
+
+void WriteDest(UnitState& state, DestRegister dest, SwizzlePattern swiz, const Register& value) {
+    Register& dest_reg{dest.GetRegisterType() == RegisterType::Output
+                           ? state.registers.output[dest.GetIndex()]
+                           : state.registers.temporary[dest.GetIndex()]};
+    for (unsigned component{}; component < 4; ++component)
+        if (swiz.DestComponentEnabled(component))
+            dest_reg[component] = value[component];
+}
+
+s32 GetAddressOffset(const UnitState& state, unsigned address_register_index) {
+    switch (address_register_index) {
+    case 1: // address offset 1
+        return state.address_registers[0];
+    case 2: // address offset 2
+        return state.address_registers[1];
+    case 3: // address offset 3
+        return state.address_registers[2];
+    default:
+        return 0;
+    }
+}
+
+/// Converts to an integer using truncation, with the result of CVTTSS2SI for invalid values
+s32 ToAddress(float value) {
+    if (!(value > -2147483904.f && value < 2147483648.f))
+        return INT32_MIN;
+    return static_cast<s32>(value);
+}
+
+/// Sums the products in the same order as the JIT: (x + y) + (z + w)
+float24 Dot(const Register& src1, const Register& src2, unsigned num_components) {
+    float24 products[4];
+    for (unsigned component{}; component < num_components; ++component)
+        products[component] = src1[component] * src2[component];
+    if (num_components == 3)
+        return (products[0] + products[1]) + products[2];
+    return (products[0] + products[1]) + (products[2] + products[3]);
+}
+
+bool EvaluateCondition(const UnitState& state, Instruction::FlowControlType flow_control) {
+    const bool result_x{flow_control.refx.Value() == state.conditional_code[0]};
+    const bool result_y{flow_control.refy.Value() == state.conditional_code[1]};
+    switch (flow_control.op) {
+    case Instruction::FlowControlType::Or:
+        return result_x || result_y;
+    case Instruction::FlowControlType::And:
+        return result_x && result_y;
+    case Instruction::FlowControlType::JustX:
+        return result_x;
+    case Instruction::FlowControlType::JustY:
+        return result_y;
+    default:
+        UNREACHABLE();
+        return false;
+    }
+}
+
+void RunArithmetic(const ShaderSetup& setup, UnitState& state, Instruction instr) {
+    const bool is_inverted{
+        (0 != (instr.opcode.Value().GetInfo().subtype & OpCode::Info::SrcInversed))};
+    const SwizzlePattern swiz{setup.swizzle_data[instr.common.operand_desc_id]};
+    const s32 address_offset{GetAddressOffset(state, instr.common.address_register_index)};
+    const Register src1{SwizzleSource(
+        LookupSourceRegister(setup, state, instr.common.GetSrc1(is_inverted),
+                             is_inverted ? 0 : address_offset),
+        swiz, 1)};
+    const Register src2{SwizzleSource(
+        LookupSourceRegister(setup, state, instr.common.GetSrc2(is_inverted),
+                             is_inverted ? address_offset : 0),
+        swiz, 2)};
+    const DestRegister dest{instr.common.dest.Value()};
+    const float24 one{float24::FromFloat32(1.f)};
+    const float24 zero{float24::Zero()};
+    Register result;
+    switch (instr.opcode.Value().EffectiveOpCode()) {
+    case OpCode::Id::ADD:
+        for (unsigned i{}; i < 4; ++i)
+            result[i] = src1[i] + src2[i];
+        break;
+    case OpCode::Id::MUL:
+        for (unsigned i{}; i < 4; ++i)
+            result[i] = src1[i] * src2[i];
+        break;
+    case OpCode::Id::FLR:
+        for (unsigned i{}; i < 4; ++i)
+            result[i] = float24::FromFloat32(std::floor(src1[i].ToFloat32()));
+        break;
+    case OpCode::Id::MAX:
+        // Returns src2 if either is NaN, like MAXPS
+        for (unsigned i{}; i < 4; ++i)
+            result[i] = src1[i] > src2[i] ? src1[i] : src2[i];
+        break;
+    case OpCode::Id::MIN:
+        // Returns src2 if either is NaN, like MINPS
+        for (unsigned i{}; i < 4; ++i)
+            result[i] = src1[i] < src2[i] ? src1[i] : src2[i];
+        break;
+    case OpCode::Id::DP3: {
+        const float24 dot{Dot(src1, src2, 3)};
+        result = Math::MakeVec(dot, dot, dot, dot);
+        break;
+    }
+    case OpCode::Id::DP4: {
+        const float24 dot{Dot(src1, src2, 4)};
+        result = Math::MakeVec(dot, dot, dot, dot);
+        break;
+    }
+    case OpCode::Id::DPH:
+    case OpCode::Id::DPHI: {
+        const float24 dot{Dot(Math::MakeVec(src1[0], src1[1], src1[2], one), src2, 4)};
+        result = Math::MakeVec(dot, dot, dot, dot);
+        break;
+    }
+    case OpCode::Id::RCP: {
+        const float24 rcp{one / src1[0]};
+        result = Math::MakeVec(rcp, rcp, rcp, rcp);
+        break;
+    }
+    case OpCode::Id::RSQ: {
+        const float24 rsq{float24::FromFloat32(1.f / std::sqrt(src1[0].ToFloat32()))};
+        result = Math::MakeVec(rsq, rsq, rsq, rsq);
+        break;
+    }
+    case OpCode::Id::EX2: {
+        const float24 ex2{float24::FromFloat32(std::exp2(src1[0].ToFloat32()))};
+        result = Math::MakeVec(ex2, ex2, ex2, ex2);
+        break;
+    }
+    case OpCode::Id::LG2: {
+        const float24 lg2{float24::FromFloat32(std::log2(src1[0].ToFloat32()))};
+        result = Math::MakeVec(lg2, lg2, lg2, lg2);
+        break;
+    }
+    case OpCode::Id::MOVA:
+        for (unsigned i{}; i < 2; ++i)
+            if (swiz.DestComponentEnabled(i))
+                state.address_registers[i] = ToAddress(src1[i].ToFloat32());
+        return;
+    case OpCode::Id::MOV:
+        result = src1;
+        break;
+    case OpCode::Id::SGE:
+    case OpCode::Id::SGEI:
+        for (unsigned i{}; i < 4; ++i)
+            result[i] = src1[i] >= src2[i] ? one : zero;
+        break;
+    case OpCode::Id::SLT:
+    case OpCode::Id::SLTI:
+        for (unsigned i{}; i < 4; ++i)
+            result[i] = src1[i] < src2[i] ? one : zero;
+        break;
+    case OpCode::Id::CMP: {
+        using Op = Instruction::Common::CompareOpType::Op;
+        const Op ops[]{instr.common.compare_op.x, instr.common.compare_op.y};
+        for (unsigned i{}; i < 2; ++i) {
+            switch (ops[i]) {
+            case Op::Equal:
+                state.conditional_code[i] = src1[i] == src2[i];
+                break;
+            case Op::NotEqual:
+                state.conditional_code[i] = src1[i] != src2[i];
+                break;
+            case Op::LessThan:
+                state.conditional_code[i] = src1[i] < src2[i];
+                break;
+            case Op::LessEqual:
+                state.conditional_code[i] = src1[i] <= src2[i];
+                break;
+            case Op::GreaterThan:
+                state.conditional_code[i] = src1[i] > src2[i];
+                break;
+            case Op::GreaterEqual:
+                state.conditional_code[i] = src1[i] >= src2[i];
+                break;
+            default:
+                LOG_ERROR(HW_GPU, "Unknown compare mode {:x}", static_cast<int>(ops[i]));
+                break;
+            }
+        }
+        return;
+    }
+    default:
+        // Unhandled instructions are reported by the JIT
+        return;
+    }
+    WriteDest(state, dest, swiz, result);
+}
+
+void RunMultiplyAdd(const ShaderSetup& setup, UnitState& state, Instruction instr) {
+    const bool is_inverted{
+        (0 != (instr.opcode.Value().GetInfo().subtype & OpCode::Info::SrcInversed))};
+    const bool is_madi{instr.opcode.Value().EffectiveOpCode() == OpCode::Id::MADI};
+    const SwizzlePattern swiz{setup.swizzle_data[instr.mad.operand_desc_id]};
+    const s32 address_offset{GetAddressOffset(state, instr.mad.address_register_index)};
+    const Register src1{
+        SwizzleSource(LookupSourceRegister(setup, state, instr.mad.src1.Value(), 0), swiz, 1)};
+    const Register src2{SwizzleSource(LookupSourceRegister(setup, state,
+                                                           instr.mad.GetSrc2(is_madi),
+                                                           is_inverted ? 0 : address_offset),
+                                      swiz, 2)};
+    const Register src3{SwizzleSource(LookupSourceRegister(setup, state,
+                                                           instr.mad.GetSrc3(is_madi),
+                                                           is_inverted ? address_offset : 0),
+                                      swiz, 3)};
+    Register result;
+    for (unsigned i{}; i < 4; ++i)
+        result[i] = src1[i] * src2[i] + src3[i];
+    WriteDest(state, instr.mad.dest.Value(), swiz, result);
+}
+
+} // Anonymous namespace
+
+void RunInterpreter(const ShaderSetup& setup, UnitState& state, unsigned entry_point) {
+    std::array<CallStackElement, MAX_CALL_STACK_DEPTH> call_stack;
+    std::size_t call_stack_depth{};
+    u32 program_counter{entry_point};
+    // Enters a scope that starts at offset, returning to return_offset after num_instructions
+    auto call{[&](u32 offset, u32 num_instructions, u32 return_offset, u32 repeat_count,
+                  u32 loop_increment, bool is_loop) {
+        if (call_stack_depth == call_stack.size()) {
+            LOG_ERROR(HW_GPU, "Shader call stack overflow at offset {}", program_counter);
+            return false;
+        }
+        call_stack[call_stack_depth++] = {offset + num_instructions, return_offset, repeat_count,
+                                          loop_increment, offset, is_loop};
+        program_counter = offset;
+        return true;
+    }};
+    for (;;) {
+        if (call_stack_depth != 0) {
+            CallStackElement& top{call_stack[call_stack_depth - 1]};
+            if (program_counter == top.final_address) {
+                state.address_registers[2] += top.loop_increment;
+                if (top.repeat_counter-- == 0) {
+                    program_counter = top.return_address;
+                    --call_stack_depth;
+                } else
+                    program_counter = top.loop_address;
+                // Several scopes can end at the same address
+                continue;
+            }
+        }
+        if (program_counter >= MAX_PROGRAM_CODE_LENGTH)
+            return;
+        const Instruction instr{setup.program_code[program_counter]};
+        switch (instr.opcode.Value().GetInfo().type) {
+        case OpCode::Type::Arithmetic:
+            RunArithmetic(setup, state, instr);
+            ++program_counter;
+            continue;
+        case OpCode::Type::MultiplyAdd:
+            RunMultiplyAdd(setup, state, instr);
+            ++program_counter;
+            continue;
+        default:
+            break;
+        }
+        const auto& flow_control{instr.flow_control};
+        const u32 dest_offset{flow_control.dest_offset};
+        const u32 num_instructions{flow_control.num_instructions};
+        const u32 next_offset{program_counter + 1};
+        switch (instr.opcode.Value().EffectiveOpCode()) {
+        case OpCode::Id::END:
+            return;
+        case OpCode::Id::JMPC:
+            program_counter = EvaluateCondition(state, flow_control) ? dest_offset : next_offset;
+            break;
+        case OpCode::Id::JMPU:
+            // The lowest bit of num_instructions inverts the condition
+            program_counter = setup.uniforms.b[flow_control.bool_uniform_id] !=
+                                      static_cast<bool>(num_instructions & 1)
+                                  ? dest_offset
+                                  : next_offset;
+            break;
+        case OpCode::Id::CALL:
+            if (!call(dest_offset, num_instructions, next_offset, 0, 0, false))
+                return;
+            break;
+        case OpCode::Id::CALLC:
+            if (!EvaluateCondition(state, flow_control))
+                program_counter = next_offset;
+            else if (!call(dest_offset, num_instructions, next_offset, 0, 0, false))
+                return;
+            break;
+        case OpCode::Id::CALLU:
+            if (!setup.uniforms.b[flow_control.bool_uniform_id])
+                program_counter = next_offset;
+            else if (!call(dest_offset, num_instructions, next_offset, 0, 0, false))
+                return;
+            break;
+        case OpCode::Id::IFU:
+        case OpCode::Id::IFC: {
+            const bool condition{instr.opcode.Value() == OpCode::Id::IFU
+                                     ? setup.uniforms.b[flow_control.bool_uniform_id]
+                                     : EvaluateCondition(state, flow_control)};
+            const bool entered{
+                condition ? call(next_offset, dest_offset - next_offset,
+                                 dest_offset + num_instructions, 0, 0, false)
+                          : call(dest_offset, num_instructions, dest_offset + num_instructions, 0,
+                                 0, false)};
+            if (!entered)
+                return;
+            break;
+        }
+        case OpCode::Id::LOOP: {
+            const Math::Vec4<u8>& loop_param{setup.uniforms.i[flow_control.int_uniform_id]};
+            state.address_registers[2] = loop_param.y;
+            if (!call(next_offset, dest_offset + 1 - next_offset, dest_offset + 1, loop_param.x,
+                      loop_param.z, true))
+                return;
+            break;
+        }
+        case OpCode::Id::BREAKC:
+            program_counter = next_offset;
+            if (!EvaluateCondition(state, flow_control))
+                break;
+            // Leave the scopes up to and including the innermost loop
+            for (std::size_t depth{call_stack_depth}; depth != 0; --depth) {
+                if (call_stack[depth - 1].is_loop) {
+                    program_counter = call_stack[depth - 1].return_address;
+                    call_stack_depth = depth - 1;
+                    break;
+                }
+            }
+            break;
+        case OpCode::Id::EMIT:
+            if (state.emitter_ptr)
+                state.emitter_ptr->Emit(state.registers.output);
+            else
+                LOG_CRITICAL(HW_GPU, "Execute EMIT on VS");
+            program_counter = next_offset;
+            break;
+        case OpCode::Id::SETEMIT:
+            if (state.emitter_ptr) {
+                state.emitter_ptr->vertex_id = instr.setemit.vertex_id;
+                state.emitter_ptr->prim_emit = instr.setemit.prim_emit != 0;
+                state.emitter_ptr->winding = instr.setemit.winding != 0;
+            } else
+                LOG_CRITICAL(HW_GPU, "Execute SETEMIT on VS");
+            program_counter = next_offset;
+            break;
+        default:
+            // NOP and unhandled instructions
+            program_counter = next_offset;
+            break;
+        }
+    }
+}
+
+} // namespace Pica::Shader
@@ -0,0 +1,23 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+namespace Pica::Shader {
+
+struct ShaderSetup;
+struct UnitState;
+
+/**
+ * Runs a shader program without compiling it, with the same results as the JIT except for the
+ * approximations the JIT uses for RCP, RSQ, EX2 and LG2. Unlike the JIT, nested loops and
+ * backwards flow control are supported.
+ *
+ * @param setup Shader engine state, with the program and the uniforms.
+ * @param state Shader unit state, must be setup with input data before each shader invocation.
+ * @param entry_point Offset of the first instruction to run.
+ */
+void RunInterpreter(const ShaderSetup& setup, UnitState& state, unsigned entry_point);
+
+} // namespace Pica::Shader
@@ -1,9 +1,11 @@
 #include <memory>
+#include <unordered_map>
 #include <boost/range/algorithm/fill.hpp>
 #include "common/alignment.h"
 #include "common/assert.h"
 #include "common/bit_field.h"
 #include "common/common_types.h"
+#include "common/hash.h"
 #include "common/logging/log.h"
 #include "common/vector_math.h"
 #include "core/core.h"
@@ -13,10 +15,21 @@
 #include "video_core/regs_pipeline.h"
 #include "video_core/shader/shader.h"
 #include "video_core/vertex_loader.h"
+#include "video_core/vertex_loader_jit.h"
 
 namespace Pica {
 
-void VertexLoader::Setup(const PipelineRegs& regs) {
+/// Returns the compiled loader of a layout, compiling it if it isn't cached
+static const VertexLoaderJit* GetCompiledLoader(
+    const Common::HashableStruct<VertexLoaderLayout>& layout) {
+    static std::unordered_map<u64, std::unique_ptr<VertexLoaderJit>> cache;
+    auto& loader{cache[layout.Hash()]};
+    if (!loader)
+        loader = std::make_unique<VertexLoaderJit>(layout.state);
+    return loader.get();
+}
+
+void VertexLoader::Setup(const PipelineRegs& regs, u32 max_vertex) {
     ASSERT_MSG(!is_setup, "VertexLoader isn't intended to be setup more than once.");
     const auto& attribute_config{regs.vertex_attributes};
     num_total_attributes = attribute_config.GetNumTotalAttributes();
@@ -57,12 +70,41 @@ void VertexLoader::Setup(const PipelineRegs& regs) {
                                // component
         }
     }
+    // Compile the loader, unless an attribute array reaches outside the memory region it starts
+    // in for some of the loaded vertices. The compiled loader doesn't check addresses, while the
+    // interpreted one reports the errors.
+    auto& memory{Core::System::GetInstance().Memory()};
+    const PAddr base_address{attribute_config.GetPhysicalBaseAddress()};
+    Common::HashableStruct<VertexLoaderLayout> layout;
+    layout.state.num_total_attributes = static_cast<u32>(num_total_attributes);
+    bool can_compile{true};
+    for (int i{}; i < num_total_attributes; ++i) {
+        if (vertex_attribute_elements[i] != 0) {
+            const PAddr source{base_address + vertex_attribute_sources[i]};
+            const u64 size{static_cast<u64>(max_vertex) * vertex_attribute_strides[i] +
+                           attribute_config.GetStride(i)};
+            if (memory.IsValidPhysicalRange(source, size))
+                vertex_attribute_pointers[i] = memory.GetPhysicalPointer(source);
+            else
+                can_compile = false;
+            layout.state.strides[i] = vertex_attribute_strides[i];
+            layout.state.elements[i] = vertex_attribute_elements[i];
+            layout.state.formats[i] = vertex_attribute_formats[i];
+        } else
+            layout.state.is_default[i] = vertex_attribute_is_default[i];
+    }
+    if (can_compile)
+        jit = GetCompiledLoader(layout);
     is_setup = true;
 }
 
 void VertexLoader::LoadVertex(u32 base_address, int index, int vertex,
                               Shader::AttributeBuffer& input) {
     ASSERT_MSG(is_setup, "A VertexLoader needs to be setup before loading vertices.");
+    if (jit) {
+        jit->Load(static_cast<u32>(vertex), vertex_attribute_pointers.data(), input);
+        return;
+    }
     auto& memory{Core::System::GetInstance().Memory()};
     for (int i{}; i < num_total_attributes; ++i) {
         if (vertex_attribute_elements[i] != 0) {
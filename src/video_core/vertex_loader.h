@@ -10,14 +10,17 @@ namespace Shader {
 struct AttributeBuffer;
 }
 
+class VertexLoaderJit;
+
 class VertexLoader {
 public:
     VertexLoader() = default;
-    explicit VertexLoader(const PipelineRegs& regs) {
-        Setup(regs);
+    VertexLoader(const PipelineRegs& regs, u32 max_vertex) {
+        Setup(regs, max_vertex);
     }
 
-    void Setup(const PipelineRegs& regs);
+    /// Sets up loading the vertices up to max_vertex, the largest vertex index of the draw
+    void Setup(const PipelineRegs& regs, u32 max_vertex);
     void LoadVertex(u32 base_address, int index, int vertex, Shader::AttributeBuffer& input);
 
     int GetNumTotalAttributes() const {
@@ -30,6 +33,9 @@ private:
     std::array<PipelineRegs::VertexAttributeFormat, 16> vertex_attribute_formats;
     std::array<u32, 16> vertex_attribute_elements{};
     std::array<bool, 16> vertex_attribute_is_default;
+    /// Host pointers to the first element of each attribute, used by the compiled loader
+    std::array<const u8*, 16> vertex_attribute_pointers{};
+    const VertexLoaderJit* jit{}; ///< Compiled loader, null if the attributes can't be compiled
     int num_total_attributes{};
     bool is_setup{};
 };
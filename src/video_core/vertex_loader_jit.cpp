@@ -0,0 +1,139 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstddef>
+#include "common/assert.h"
+#include "common/logging/log.h"
+#include "common/x64/xbyak_abi.h"
+#include "video_core/pica_state.h"
+#include "video_core/shader/shader.h"
+#include "video_core/vertex_loader_jit.h"
+
+using namespace Common::X64;
+using namespace Xbyak::util;
+
+namespace Pica {
+
+/// Memory allocated for each compiled loader, enough for 16 attributes with the longest sequences
+constexpr std::size_t MAX_LOADER_SIZE{4096};
+
+using Format = PipelineRegs::VertexAttributeFormat;
+
+VertexLoaderJit::VertexLoaderJit(const VertexLoaderLayout& layout)
+    : Xbyak::CodeGenerator{MAX_LOADER_SIZE} {
+    align(16);
+    default_w_vector = getCurr();
+    dd(0);
+    dd(0);
+    dd(0);
+    dd(0x3f800000);
+    align(16);
+    program = (CompiledLoader*)getCurr();
+    // rax holds the vertex index, r10 the address of the current attribute and r11 is a scratch
+    // register. These are caller saved in both ABIs, so nothing needs to be preserved.
+    mov(eax, ABI_PARAM1.cvt32());
+    for (u32 i{}; i < layout.num_total_attributes; ++i) {
+        if (layout.elements[i] != 0) {
+            imul(r10, rax, static_cast<int>(layout.strides[i]));
+            add(r10, qword[ABI_PARAM2 + i * sizeof(u8*)]);
+            Compile_LoadAttribute(layout.formats[i], layout.elements[i]);
+        } else if (layout.is_default[i]) {
+            // The default attributes can change between draws, so they're read when loading
+            mov(r11, reinterpret_cast<std::size_t>(&g_state.input_default_attributes.attr[i]));
+            movaps(xmm0, xword[r11]);
+        } else
+            // Keep the value the buffer already has, like the interpreted loader does
+            continue;
+        movaps(xword[ABI_PARAM3 + i * sizeof(Math::Vec4<float24>)], xmm0);
+    }
+    ret();
+    ready();
+    ASSERT_MSG(getSize() <= MAX_LOADER_SIZE, "Compiled a loader that exceeds the allocated size!");
+    LOG_DEBUG(HW_GPU, "Compiled vertex loader size={}", getSize());
+}
+
+/**
+ * Loads the attribute at r10 into xmm0 as floats. Only the bytes of the loaded elements are read,
+ * and components that aren't loaded are set to 0, except for w, which is set to 1.
+ */
+void VertexLoaderJit::Compile_LoadAttribute(Format format, u32 elements) {
+    switch (format) {
+    case Format::Float:
+        switch (elements) {
+        case 1:
+            movss(xmm0, dword[r10]);
+            break;
+        case 2:
+            movq(xmm0, qword[r10]);
+            break;
+        case 3:
+            movq(xmm0, qword[r10]);
+            movss(xmm1, dword[r10 + 8]);
+            movlhps(xmm0, xmm1);
+            break;
+        case 4:
+            movups(xmm0, xword[r10]);
+            break;
+        }
+        break;
+    case Format::Byte:
+    case Format::UnsignedByte:
+        switch (elements) {
+        case 1:
+            movzx(r11d, byte[r10]);
+            movd(xmm0, r11d);
+            break;
+        case 2:
+            movzx(r11d, word[r10]);
+            movd(xmm0, r11d);
+            break;
+        case 3:
+            movzx(r11d, byte[r10 + 2]);
+            shl(r11d, 16);
+            mov(r11w, word[r10]);
+            movd(xmm0, r11d);
+            break;
+        case 4:
+            movd(xmm0, dword[r10]);
+            break;
+        }
+        if (format == Format::Byte) {
+            // Sign extend by moving each byte to the top of its dword
+            punpcklbw(xmm0, xmm0);
+            punpcklwd(xmm0, xmm0);
+            psrad(xmm0, 24);
+        } else {
+            pxor(xmm1, xmm1);
+            punpcklbw(xmm0, xmm1);
+            punpcklwd(xmm0, xmm1);
+        }
+        cvtdq2ps(xmm0, xmm0);
+        break;
+    case Format::Short:
+        switch (elements) {
+        case 1:
+            movzx(r11d, word[r10]);
+            movd(xmm0, r11d);
+            break;
+        case 2:
+            movd(xmm0, dword[r10]);
+            break;
+        case 3:
+            movd(xmm0, dword[r10]);
+            pinsrw(xmm0, word[r10 + 4], 2);
+            break;
+        case 4:
+            movq(xmm0, qword[r10]);
+            break;
+        }
+        punpcklwd(xmm0, xmm0);
+        psrad(xmm0, 16);
+        cvtdq2ps(xmm0, xmm0);
+        break;
+    }
+    if (elements < 4)
+        orps(xmm0, xword[rip + default_w_vector]);
+}
+
+} // namespace Pica
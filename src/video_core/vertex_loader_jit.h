@@ -0,0 +1,53 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <xbyak.h>
+#include "common/common_types.h"
+#include "video_core/regs_pipeline.h"
+
+namespace Pica {
+
+namespace Shader {
+struct AttributeBuffer;
+}
+
+/// Describes how each vertex attribute is loaded. Used as the key of compiled vertex loaders.
+struct VertexLoaderLayout {
+    std::array<u32, 16> strides;
+    std::array<u32, 16> elements; ///< 0 if the attribute isn't loaded from an array
+    std::array<PipelineRegs::VertexAttributeFormat, 16> formats;
+    std::array<bool, 16> is_default;
+    u32 num_total_attributes;
+};
+
+/// This class compiles the loading of vertices with a given attribute layout into x86_64 code.
+/// Attributes are converted to float24 with SSE2 and written to the buffer with one store each.
+class VertexLoaderJit : public Xbyak::CodeGenerator {
+public:
+    explicit VertexLoaderJit(const VertexLoaderLayout& layout);
+
+    /**
+     * Loads a vertex.
+     * @param vertex Index of the vertex in the attribute arrays
+     * @param attribute_pointers Pointers to the first element of each loaded attribute
+     * @param output Buffer the attributes are written to
+     */
+    void Load(u32 vertex, const u8* const* attribute_pointers,
+              Shader::AttributeBuffer& output) const {
+        program(vertex, attribute_pointers, &output);
+    }
+
+private:
+    void Compile_LoadAttribute(PipelineRegs::VertexAttributeFormat format, u32 elements);
+
+    using CompiledLoader = void(u32 vertex, const u8* const* attribute_pointers,
+                                Shader::AttributeBuffer* output);
+    CompiledLoader* program{};
+    const void* default_w_vector{}; ///< (0, 0, 0, 1), the values of components that aren't loaded
+};
+
+} // namespace Pica